@@ -0,0 +1,235 @@
+#include "batch_job.h"
+#include "hex_converter.h"
+#include "flash_session.h"
+#include "controller_session.h"
+
+#include <QFile>
+#include <QRegExp>
+
+BatchJob::BatchJob(const Options &options, QObject *parent) :
+    QObject(parent),
+    m_options(options),
+    m_link(0),
+    m_exitCode(ExitOk)
+{
+}
+
+int BatchJob::run()
+{
+    m_steps = QJsonArray();
+    m_rtt = QJsonObject();
+    m_error.clear();
+    m_exitCode = ExitOk;
+    m_totalTime.start();
+
+    if (!m_options.flashFile.isEmpty())
+    {
+        QFile file(m_options.flashFile);
+        if (!file.open(QFile::ReadOnly))
+            return fail(ExitFileError, QString("Can't open %1").arg(m_options.flashFile));
+        qint64 size = file.size();
+        const char *data = reinterpret_cast<const char*>(file.map(0, size));
+        QByteArray contents;
+        if (data == 0)
+        {
+            contents = file.readAll();
+            data = contents.constData();
+        }
+        QString error = hexFileToImage(data, size, &m_image);
+        if (!error.isEmpty())
+            return fail(ExitFileError, error);
+    }
+
+    LinLink link;
+    m_link = &link;
+    if (!link.open(m_options.port, m_options.baudRate))
+    {
+        m_link = 0;
+        return fail(ExitPortError, QString("Can't open port %1").arg(m_options.port));
+    }
+
+    int result = ExitOk;
+    if (!m_options.flashFile.isEmpty())
+        result = flash();
+    if ((result == ExitOk) && m_options.readRange)
+        result = readRange();
+    if ((result == ExitOk) && !m_options.settingsFile.isEmpty())
+        result = writeSettings();
+    if ((result == ExitOk) && m_options.eepromCommit)
+        result = eepromCommit();
+
+    m_rtt = QJsonObject();
+    foreach (const LinRttStats &stats, link.rttStats())
+    {
+        QJsonObject command;
+        command["samples"] = stats.samples;
+        command["srttMs"] = stats.srtt;
+        command["rttvarMs"] = stats.rttvar;
+        command["timeoutMs"] = stats.timeout;
+        m_rtt[stats.name] = command;
+    }
+    link.close();
+    m_link = 0;
+    return result;
+}
+
+QJsonObject BatchJob::report() const
+{
+    QJsonObject report;
+    report["port"] = m_options.port;
+    report["baud"] = m_options.baudRate;
+    report["steps"] = m_steps;
+    report["rtt"] = m_rtt;
+    report["exitCode"] = m_exitCode;
+    report["error"] = m_error;
+    report["totalMs"] = m_totalTime.elapsed();
+    return report;
+}
+
+int BatchJob::flash()
+{
+    QElapsedTimer time;
+    time.start();
+    FlashWritePlan plan(m_image);
+    FlashSession session(m_link);
+    DeviceSnapshotCache cache(m_options.snapshotDirectory);
+    if (!m_options.snapshotDirectory.isEmpty())
+        session.setSnapshotCache(&cache);
+    FlashJournal journal(m_options.resume ? FlashJournal::defaultFileName(m_options.port) : QString());
+    session.setJournal(&journal);
+    QVector<int32_t> mismatches;
+    LinReply::Error error = session.applySnapshot(m_image, &plan);
+    if ((error == LinReply::NoError) && m_options.verify)
+        error = session.writeVerified(m_image, plan, &mismatches);
+    else if (error == LinReply::NoError)
+        error = session.write(m_image, plan);
+    QJsonObject step;
+    step["rows"] = plan.frames();
+    step["skippedRows"] = plan.skippedRows();
+    step["unchangedRows"] = plan.unchangedRows();
+    step["resumedRows"] = journal.resumedRows();
+    step["configRows"] = plan.configRows();
+    step["bytes"] = plan.bytes();
+    step["estimatedMs"] = plan.estimatedTime(m_options.baudRate);
+    if (m_options.verify)
+    {
+        QJsonArray mismatchedRows;
+        for (int32_t address : mismatches)
+            mismatchedRows.append(address);
+        step["mismatches"] = mismatchedRows;
+    }
+    if (error != LinReply::NoError)
+    {
+        step["address"] = session.errorAddress();
+        QJsonArray unconfirmedRows;
+        for (int32_t address : session.unconfirmedRows())
+            unconfirmedRows.append(address);
+        step["unconfirmed"] = unconfirmedRows;
+    }
+    addStep(m_options.verify ? "flash+verify" : "flash", time.elapsed(), FlashSession::errorString(error), step);
+    if (error != LinReply::NoError)
+        return fail(ExitLinError, QString("Flash write at %1: %2").arg(session.errorAddress(), 4, 16, QChar('0')).arg(FlashSession::errorString(error)));
+    if (!mismatches.isEmpty())
+        return fail(ExitVerifyError, QString("%1 rows differ from image").arg(mismatches.size()));
+    return ExitOk;
+}
+
+int BatchJob::readRange()
+{
+    QElapsedTimer time;
+    time.start();
+    FlashSession session(m_link);
+    DeviceSnapshotCache cache(m_options.snapshotDirectory);
+    if (!m_options.snapshotDirectory.isEmpty())
+        session.setSnapshotCache(&cache);
+    FlashJournal journal(m_options.resume ? FlashJournal::defaultFileName(m_options.port) : QString());
+    session.setJournal(&journal);
+    FlashImage readImage;
+    LinReply::Error error = session.read(m_options.readStart, m_options.readEnd, &readImage);
+    QJsonObject step;
+    step["rows"] = readImage.rowsCount();
+    step["resumedRows"] = journal.resumedRows();
+    addStep("read", time.elapsed(), FlashSession::errorString(error), step);
+    if (error != LinReply::NoError)
+        return fail(ExitLinError, QString("Flash read at %1: %2").arg(session.errorAddress(), 4, 16, QChar('0')).arg(FlashSession::errorString(error)));
+
+    QFile output(m_options.outputFile);
+    if (!output.open(QFile::WriteOnly | QFile::Truncate) || (output.write(imageToHexFile(readImage)) < 0))
+        return fail(ExitFileError, QString("Can't write %1").arg(m_options.outputFile));
+    return ExitOk;
+}
+
+int BatchJob::writeSettings()
+{
+    QByteArray settings;
+    QString error = loadSettingsFile(m_options.settingsFile, &settings);
+    if (!error.isEmpty())
+        return fail(ExitFileError, error);
+
+    QElapsedTimer time;
+    time.start();
+    ControllerSession session(m_link);
+    error = session.writeSettings(settings);
+    addStep("settings", time.elapsed(), error);
+    if (!error.isEmpty())
+        return fail(ExitControllerError, error);
+    return ExitOk;
+}
+
+int BatchJob::eepromCommit()
+{
+    QElapsedTimer time;
+    time.start();
+    ControllerSession session(m_link);
+    QString error = session.writeToEeprom();
+    addStep("eeprom", time.elapsed(), error);
+    if (!error.isEmpty())
+        return fail(ExitControllerError, error);
+    return ExitOk;
+}
+
+int BatchJob::fail(int exitCode, const QString &error)
+{
+    m_exitCode = exitCode;
+    m_error = error;
+    return exitCode;
+}
+
+void BatchJob::addStep(const QString &name, qint64 time, const QString &error, QJsonObject step)
+{
+    step["step"] = name;
+    step["ms"] = time;
+    step["ok"] = error.isEmpty();
+    if (!error.isEmpty())
+        step["error"] = error;
+    m_steps.append(step);
+}
+
+QString loadSettingsFile(const QString &fileName, QByteArray *settings)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+        return QString("Can't open %1").arg(fileName);
+    QByteArray contents = file.readAll();
+
+    QByteArray values;
+    if (contents.size() == SETTINGS_SIZE)
+        values = contents;
+    else
+    {
+        QStringList numbers = QString::fromLatin1(contents).split(QRegExp("[\\s,;]+"), Qt::SkipEmptyParts);
+        for (const QString &number : numbers)
+        {
+            bool ok;
+            int value = number.toInt(&ok, 0);
+            if (!ok || (value < -128) || (value > 255))
+                return QString("%1: not correct value %2").arg(fileName).arg(number);
+            values.append(static_cast<char>(value));
+        }
+    }
+    QString errors = checkSettings(values);
+    if (!errors.isEmpty())
+        return QString("%1: %2").arg(fileName).arg(errors.trimmed());
+    *settings = values;
+    return QString();
+}
@@ -0,0 +1,88 @@
+#ifndef BATCH_JOB_H
+#define BATCH_JOB_H
+
+#include <QObject>
+#include <QString>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QElapsedTimer>
+
+#include "flash_image.h"
+#include "lin_link.h"
+
+// One scripted run over one port: flash (with verify), read range, settings, EEPROM commit.
+// Steps go in this order, first failed step stops the job.
+class BatchJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ExitCode
+    {
+        ExitOk = 0,
+        ExitUsage = 1,
+        ExitPortError = 2,
+        ExitFileError = 3,
+        ExitLinError = 4,
+        ExitVerifyError = 5,
+        ExitControllerError = 6
+    };
+
+    struct Options
+    {
+        QString port;
+        int baudRate;
+        QString flashFile;
+        bool verify;
+        bool readRange;
+        int32_t readStart;
+        int32_t readEnd;
+        QString outputFile;
+        QString settingsFile;
+        bool eepromCommit;
+        QString snapshotDirectory;  // EMPTY IF NOT DIFFERENTIAL
+        bool resume;
+    };
+
+    explicit BatchJob(const Options &options, QObject *parent = 0);
+
+    int run();
+
+    // MACHINE READABLE RESULT OF LAST RUN
+    QJsonObject report() const;
+
+private:
+    Options m_options;
+
+    LinLink *m_link;
+
+    FlashImage m_image;
+
+    QJsonArray m_steps;
+
+    // LEARNED TIMING OF LINK, SEE RttEstimator
+    QJsonObject m_rtt;
+
+    QString m_error;
+
+    int m_exitCode;
+
+    QElapsedTimer m_totalTime;
+
+    int flash();
+
+    int readRange();
+
+    int writeSettings();
+
+    int eepromCommit();
+
+    int fail(int exitCode, const QString &error);
+
+    void addStep(const QString &name, qint64 time, const QString &error, QJsonObject step = QJsonObject());
+};
+
+// SETTINGS FILE: 54 BYTES BINARY OR 54 NUMBERS SEPARATED BY SPACES/COMMAS (0x PREFIX FOR HEX)
+QString loadSettingsFile(const QString &fileName, QByteArray *settings);
+
+#endif // BATCH_JOB_H
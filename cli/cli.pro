@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# Headless batch flasher
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = lin_flasher
+TEMPLATE = app
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../core/core.pri)
+
+SOURCES += \
+    main.cpp \
+    batch_job.cpp
+
+HEADERS += \
+    batch_job.h
@@ -0,0 +1,88 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <QTimer>
+
+#include <stdio.h>
+
+#include "batch_job.h"
+#include "device_snapshot_cache.h"
+
+static bool parseRange(const QString &text, int32_t *start, int32_t *end)
+{
+    QStringList parts = text.split(':');
+    if (parts.size() != 2)
+        return false;
+    bool startOk, endOk;
+    *start = parts.at(0).toInt(&startOk, 0);
+    *end = parts.at(1).toInt(&endOk, 0);
+    return startOk && endOk && (*start >= 0) && (*end >= *start);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("lin_flasher");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Batch flasher for PIC12F1822 bootloader and corrector controller settings.\n"
+                                     "Prints JSON report to stdout. Exit codes: 0 - OK, 1 - usage, 2 - port, 3 - file,\n"
+                                     "4 - LIN error, 5 - verify mismatch, 6 - controller error.");
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", "Serial port name or path.", "port");
+    QCommandLineOption baudOption("baud", "Baud rate.", "baud", "19200");
+    QCommandLineOption flashOption("flash", "Write hex image to flash.", "image.hex");
+    QCommandLineOption verifyOption("verify", "Read back every row right after its write, rewrite different rows.");
+    QCommandLineOption readRangeOption("read-range", "Read flash words start:end (e.g. 0:0x7FF).", "range");
+    QCommandLineOption outputOption("output", "Hex file for --read-range.", "file.hex");
+    QCommandLineOption settingsOption("settings", "Send settings block to controller.", "file");
+    QCommandLineOption eepromOption("eeprom-commit", "Save controller settings to EEPROM.");
+    QCommandLineOption diffOption("diff", "Write only rows changed against cached snapshot of device flash.");
+    QCommandLineOption snapshotDirOption("snapshot-dir", "Directory of device snapshots for --diff.", "dir",
+                                         DeviceSnapshotCache::defaultDirectory());
+    QCommandLineOption resumeOption("resume", "Keep journal of confirmed rows, continue interrupted flash or read.");
+    parser.addOptions(QList<QCommandLineOption>() << portOption << baudOption << flashOption << verifyOption
+                      << readRangeOption << outputOption << settingsOption << eepromOption
+                      << diffOption << snapshotDirOption << resumeOption);
+    parser.process(a);
+
+    BatchJob::Options options;
+    options.port = parser.value(portOption);
+    options.baudRate = parser.value(baudOption).toInt();
+    options.flashFile = parser.value(flashOption);
+    options.verify = parser.isSet(verifyOption);
+    options.readRange = parser.isSet(readRangeOption);
+    options.readStart = 0;
+    options.readEnd = 0;
+    options.outputFile = parser.value(outputOption);
+    options.settingsFile = parser.value(settingsOption);
+    options.eepromCommit = parser.isSet(eepromOption);
+    options.snapshotDirectory = parser.isSet(diffOption) ? parser.value(snapshotDirOption) : QString();
+    options.resume = parser.isSet(resumeOption);
+
+    QString usageError;
+    if (options.port.isEmpty())
+        usageError = "--port is required";
+    else if (options.verify && options.flashFile.isEmpty())
+        usageError = "--verify needs --flash image";
+    else if (options.readRange && !parseRange(parser.value(readRangeOption), &options.readStart, &options.readEnd))
+        usageError = "--read-range must be start:end";
+    else if (options.readRange && options.outputFile.isEmpty())
+        usageError = "--read-range needs --output";
+    if (!usageError.isEmpty())
+    {
+        fprintf(stderr, "%s\n", qPrintable(usageError));
+        return BatchJob::ExitUsage;
+    }
+
+    BatchJob job(options);
+    int exitCode = BatchJob::ExitOk;
+    QTimer::singleShot(0, [&]() {
+        exitCode = job.run();
+        fprintf(stdout, "%s\n", QJsonDocument(job.report()).toJson(QJsonDocument::Indented).constData());
+        fflush(stdout);
+        QCoreApplication::exit(exitCode);
+    });
+    a.exec();
+    return exitCode;
+}
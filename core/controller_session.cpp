@@ -0,0 +1,206 @@
+#include "controller_session.h"
+#include "frame_layout.h"
+
+#include <QVector>
+
+ControllerSession::ControllerSession(LinLink *link, QObject *parent) :
+    QObject(parent),
+    m_link(link),
+    m_lastError(LinReply::NoError)
+{
+}
+
+LinReply::Error ControllerSession::transfer(const LinCommand &command, QByteArray frame, QByteArray *answer)
+{
+    if (frame.size() != COMMAND_FRAME_SIZE)
+        return LinReply::BadResponse;
+    placeCommandChecksum(&frame);
+
+    LinReply *reply = m_link->submit(LinRequest(&command, frame));
+    connect(reply, &LinReply::sent, this, &ControllerSession::sent);
+    reply->waitForFinished();
+    LinReply::Error error = reply->error();
+    if (error == LinReply::NoError)
+    {
+        *answer = QByteArray(reply->frame().data(), reply->frame().size);
+        track(command, frame, *answer);
+    }
+    delete reply;
+    m_lastError = error;
+    return error;
+}
+
+QString ControllerSession::readSettings(QByteArray *settings)
+{
+    QByteArray answer;
+    LinReply::Error error = transfer(readSettingsCommand, commandFrame(READ_SETTINGS_CODE), &answer);
+    if (error != LinReply::NoError)
+        return errorString(error);
+    QByteArray received = answer.mid(2, SETTINGS_SIZE);
+    QString errors = checkSettings(received);
+    if (!errors.isEmpty())
+        return errors;
+    *settings = received;
+    return QString();
+}
+
+QString ControllerSession::writeSettings(const QByteArray &settings)
+{
+    m_lastError = LinReply::NoError;
+    if (settings.size() != SETTINGS_SIZE)
+        return QString("SETTINGS SIZE NOT CORRECT");
+    return writeChunks(settings, changedSettingsChunks(QByteArray(), settings));
+}
+
+QString ControllerSession::writeChangedSettings(const QByteArray &settings, bool readBack, int *sentChunks)
+{
+    m_lastError = LinReply::NoError;
+    if (settings.size() != SETTINGS_SIZE)
+        return QString("SETTINGS SIZE NOT CORRECT");
+    QVector<int> chunks = changedSettingsChunks(m_confirmedSettings, settings);
+    if (sentChunks != 0)
+        *sentChunks = chunks.size();
+    QString error = writeChunks(settings, chunks);
+    if (!error.isEmpty() || !readBack)
+        return error;
+
+    QByteArray controllerSettings;
+    error = readSettings(&controllerSettings);
+    if (!error.isEmpty())
+        return error;
+    QVector<int> different = changedSettingsChunks(controllerSettings, settings);
+    if (!different.isEmpty())
+        return QString("Controller settings differ after write, %1 chunks, first %2").arg(different.size()).arg(different.first());
+    return QString();
+}
+
+QString ControllerSession::writeChunks(const QByteArray &settings, QVector<int> chunks)
+{
+    bool wholeBlock = (chunks.size() == SETTINGS_CHUNKS_NUM);
+    QString error;
+    for (int round = 0; (round < SETTINGS_WRITE_ROUNDS) && !chunks.isEmpty(); round++)
+    {
+        // FIRST CHUNK WAITS CONTROLLER CYCLE, OTHERS FOLLOW IT WITHOUT WAITING ACKS
+        QList<LinReply*> replies;
+        for (int i = 0; i < chunks.size(); i++)
+        {
+            QByteArray frame = commandFrame(chunks.at(i), settings.mid(chunks.at(i) * SETTINGS_CHUNK_SIZE, SETTINGS_CHUNK_SIZE));
+            LinReply *reply = m_link->submit(LinRequest((i == 0) ? &writeSettingsCommand : &writeSettingsChunkCommand, frame));
+            connect(reply, &LinReply::sent, this, &ControllerSession::sent);
+            replies.append(reply);
+        }
+
+        QVector<int> rejected;
+        error.clear();
+        m_lastError = LinReply::NoError;
+        for (int i = 0; i < replies.size(); i++)
+        {
+            LinReply *reply = replies.at(i);
+            reply->waitForFinished();
+            QByteArray answer(reply->frame().data(), reply->frame().size);
+            QString chunkError = ackError(reply->error(), answer);
+            if (chunkError.isEmpty())
+            {
+                track(*reply->request().command, reply->request().frame, answer);
+                continue;
+            }
+            rejected.append(chunks.at(i));
+            if (error.isEmpty())
+            {
+                error = chunkError;
+                m_lastError = reply->error();
+            }
+        }
+        qDeleteAll(replies);
+        // NOTHING ACCEPTED, CONTROLLER DOES NOT TAKE SETTINGS AT ALL
+        if (rejected.size() == chunks.size())
+            break;
+        chunks = rejected;
+    }
+    if (chunks.isEmpty())
+    {
+        if (wholeBlock)
+            m_confirmedSettings = settings;
+        m_lastError = LinReply::NoError;
+        return QString();
+    }
+    return error;
+}
+
+QString ControllerSession::writeToEeprom()
+{
+    return ackCommand(eepromWriteCommand, commandFrame(EEPROM_WRITE_CODE));
+}
+
+QString ControllerSession::readFromEeprom()
+{
+    return ackCommand(eepromReadCommand, commandFrame(EEPROM_READ_CODE));
+}
+
+QString ControllerSession::clearErrors()
+{
+    return ackCommand(clearErrorsCommand, commandFrame(CLEAR_ERRORS_CODE));
+}
+
+QString ControllerSession::setExtPositions(int16_t corrector1, int16_t corrector2, bool extControl)
+{
+    return ackCommand(extPositionsCommand, extPositionsFrame(corrector1, corrector2, extControl));
+}
+
+QString ControllerSession::errorString(LinReply::Error error)
+{
+    switch (error)
+    {
+    case LinReply::NoError:
+        return QString();
+    case LinReply::NoValuesFrame:
+        return "Corrector not sent current values frame";
+    case LinReply::EchoNotReceived:
+        return "Lin tranciever loop broken";
+    case LinReply::ChecksumError:
+        return "Lin checksum not correct!";
+    case LinReply::Aborted:
+        return "Aborted";
+    default:
+        return "Corrector not answered";
+    }
+}
+
+QString ControllerSession::ackCommand(const LinCommand &command, const QByteArray &frame)
+{
+    QByteArray answer;
+    LinReply::Error error = transfer(command, frame, &answer);
+    return ackError(error, answer);
+}
+
+QString ControllerSession::ackError(LinReply::Error error, const QByteArray &answer)
+{
+    if (error != LinReply::NoError)
+        return errorString(error);
+    uint8_t code = AckLayout::ErrorCode::read(reinterpret_cast<const uint8_t*>(answer.constData()));
+    if (code != 0)
+        return QString("Controller sent error code %1").arg(code);
+    return QString();
+}
+
+void ControllerSession::track(const LinCommand &command, const QByteArray &frame, const QByteArray &answer)
+{
+    if (&command == &readSettingsCommand)
+    {
+        QByteArray received = answer.mid(2, SETTINGS_SIZE);
+        m_confirmedSettings = checkSettings(received).isEmpty() ? received : QByteArray();
+    }
+    else if (&command == &eepromReadCommand)
+    {
+        // SETTINGS ARE RELOADED FROM EEPROM, WHICH TOOL DOES NOT SEE
+        m_confirmedSettings.clear();
+    }
+    else if (((&command == &writeSettingsCommand) || (&command == &writeSettingsChunkCommand))
+             && (answer.size() > 2) && (answer.at(2) == 0) && (m_confirmedSettings.size() == SETTINGS_SIZE))
+    {
+        int offset = static_cast<uint8_t>(frame.at(1)) * SETTINGS_CHUNK_SIZE;
+        int size = qMin(SETTINGS_CHUNK_SIZE, SETTINGS_SIZE - offset);
+        if (size > 0)
+            m_confirmedSettings.replace(offset, size, frame.mid(2, size));
+    }
+}
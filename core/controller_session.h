@@ -0,0 +1,74 @@
+#ifndef CONTROLLER_SESSION_H
+#define CONTROLLER_SESSION_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QVector>
+
+#include "lin_link.h"
+#include "controller_settings.h"
+
+// Corrector controller commands. Calls block in local event loop until answer, text
+// results are empty on success.
+class ControllerSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ControllerSession(LinLink *link, QObject *parent = 0);
+
+    // SENDS 11 BYTES COMMAND, CHECKSUM IS PLACED HERE
+    LinReply::Error transfer(const LinCommand &command, QByteArray frame, QByteArray *answer);
+
+    QString readSettings(QByteArray *settings);
+
+    // ALL CHUNKS GO BACK TO BACK AFTER ONE VALUES FRAME, ACKS ARE CHECKED TOGETHER AND ONLY
+    // REJECTED OR LOST CHUNKS ARE SENT AGAIN IN NEXT CYCLE
+    QString writeSettings(const QByteArray &settings);
+
+    // ONLY CHUNKS DIFFERENT FROM CONFIRMED BLOCK, WITH READ BACK SETTINGS ARE READ AND COMPARED
+    // AFTERWARDS (CONTROLLER RESET RESTORES EEPROM SETTINGS WITHOUT TELLING)
+    QString writeChangedSettings(const QByteArray &settings, bool readBack = false, int *sentChunks = 0);
+
+    // LAST SETTINGS BLOCK READ FROM OR ACKED BY CONTROLLER, EMPTY IF NOT KNOWN
+    QByteArray confirmedSettings() const { return m_confirmedSettings; }
+
+    // E.G. OTHER CONTROLLER CONNECTED
+    void forgetSettings() { m_confirmedSettings.clear(); }
+
+    QString writeToEeprom();
+
+    QString readFromEeprom();
+
+    QString clearErrors();
+
+    QString setExtPositions(int16_t corrector1, int16_t corrector2, bool extControl);
+
+    // LIN LEVEL ERROR OF LAST FAILED COMMAND, NoError IF CONTROLLER ANSWERED WITH ERROR CODE
+    LinReply::Error lastError() const { return m_lastError; }
+
+    static QString errorString(LinReply::Error error);
+
+signals:
+
+    // COMMAND WENT TO BUS, NOW WAITING ANSWER
+    void sent();
+
+private:
+    LinLink *m_link;
+
+    LinReply::Error m_lastError;
+
+    QByteArray m_confirmedSettings;
+
+    QString writeChunks(const QByteArray &settings, QVector<int> chunks);
+
+    // KEEPS m_confirmedSettings IN STEP WITH EVERY ANSWERED COMMAND
+    void track(const LinCommand &command, const QByteArray &frame, const QByteArray &answer);
+
+    QString ackCommand(const LinCommand &command, const QByteArray &frame);
+
+    QString ackError(LinReply::Error error, const QByteArray &answer);
+};
+
+#endif // CONTROLLER_SESSION_H
@@ -0,0 +1,99 @@
+#include "controller_settings.h"
+#include "frame_layout.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// FIELDS ARE BYTES, SO STRUCT IS EXACTLY THE BLOCK
+Q_STATIC_ASSERT(sizeof(ControllerSettings) == SettingsLayout::Block::size);
+Q_STATIC_ASSERT(offsetof(ControllerSettings, correctorsNum) == SettingsLayout::CorrectorsNum::offset);
+Q_STATIC_ASSERT(offsetof(ControllerSettings, positionsNum) == SettingsLayout::PositionsNum::offset);
+Q_STATIC_ASSERT(offsetof(ControllerSettings, positionMult) == SettingsLayout::PositionMult::offset);
+Q_STATIC_ASSERT(offsetof(ControllerSettings, correctorAddresses) == SettingsLayout::CorrectorAddresses::offset);
+Q_STATIC_ASSERT(offsetof(ControllerSettings, startPositions) == SettingsLayout::StartPositions::offset);
+Q_STATIC_ASSERT(offsetof(ControllerSettings, adcValues) == SettingsLayout::AdcValues::offset);
+Q_STATIC_ASSERT(offsetof(ControllerSettings, positions) == SettingsLayout::Positions::offset);
+Q_STATIC_ASSERT(sizeof(ControllerSettings::positions) == SettingsLayout::Positions::size);
+Q_STATIC_ASSERT(SETTINGS_CHUNK_SIZE == CommandLayout::Data::size);
+
+ControllerSettings ControllerSettings::fromBytes(const QByteArray &settings)
+{
+    ControllerSettings result;
+    memset(&result, 0, sizeof(result));
+    memcpy(&result, settings.constData(), qMin<int>(settings.size(), sizeof(result)));
+    return result;
+}
+
+QByteArray ControllerSettings::toBytes() const
+{
+    return QByteArray(reinterpret_cast<const char*>(this), sizeof(*this));
+}
+
+QString checkSettings(const QByteArray &settings)
+{
+    using namespace SettingsLayout;
+    QString errors;
+    if (settings.size() != Block::size)
+        return QString("SETTINGS SIZE NOT CORRECT");
+    const uint8_t *block = reinterpret_cast<const uint8_t*>(settings.constData());
+    if (!CorrectorsNum::isValid(block))
+        errors += QString("NOT MORE 2 CORRECTORS SUPPORTED (VALUE FROM SETTINGS - %1)\n").arg(CorrectorsNum::read(block));
+    if (!PositionsNum::isValid(block))
+        errors += QString("POSITIONS NUM CAN BE 2 - 16 (VALUE FROM SETTINGS - %1)\n").arg(PositionsNum::read(block));
+    if (!PositionMult::isValid(block))
+        errors += QString("POSITION MULT CANNOT BE ZERO\n");
+    return errors;
+}
+
+QByteArray defaultSettings()
+{
+    QByteArray settings(SETTINGS_SIZE, char(255));
+    settings[0] = 2;
+    settings[1] = 2;
+    settings[2] = 50;
+    settings[3] = 0xF8;
+    settings[4] = 0xF0;
+    settings[5] = 0;
+    settings[6] = 0;
+    return settings;
+}
+
+QVector<int> changedSettingsChunks(const QByteArray &oldSettings, const QByteArray &newSettings)
+{
+    QVector<int> chunks;
+    for (int chunk = 0; chunk < SETTINGS_CHUNKS_NUM; chunk++)
+    {
+        int offset = chunk * SETTINGS_CHUNK_SIZE;
+        if ((oldSettings.size() != SETTINGS_SIZE) || (oldSettings.mid(offset, SETTINGS_CHUNK_SIZE) != newSettings.mid(offset, SETTINGS_CHUNK_SIZE)))
+            chunks.append(chunk);
+    }
+    return chunks;
+}
+
+QByteArray commandFrame(uint8_t code, const QByteArray &data)
+{
+    FrameBuffer<CommandLayout::Frame> frame;
+    frame.set<CommandLayout::Sync>(LIN_SYNC_BYTE);
+    frame.set<CommandLayout::Code>(code);
+    CommandLayout::Data::write(frame.bytes, data.constData(), data.size());
+    frame.placeChecksum();
+    return frame.toByteArray();
+}
+
+QByteArray extPositionsFrame(int16_t corrector1, int16_t corrector2, bool extControl)
+{
+    FrameBuffer<ExtPositionsLayout::Frame> frame;
+    frame.set<CommandLayout::Sync>(LIN_SYNC_BYTE);
+    frame.set<CommandLayout::Code>(EXT_POSITIONS_CODE);
+    frame.set<ExtPositionsLayout::Corrector1>(corrector1);
+    frame.set<ExtPositionsLayout::Corrector2>(corrector2);
+    frame.set<ExtPositionsLayout::ExtControl>(extControl ? 1 : 0);
+    frame.placeChecksum();
+    return frame.toByteArray();
+}
+
+void placeCommandChecksum(QByteArray *frame)
+{
+    if (frame->size() == CommandLayout::Frame::size)
+        CommandLayout::Frame::placeChecksum(reinterpret_cast<uint8_t*>(frame->data()));
+}
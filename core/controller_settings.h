@@ -0,0 +1,57 @@
+#ifndef CONTROLLER_SETTINGS_H
+#define CONTROLLER_SETTINGS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "lin_frame_decoder.h"
+
+#define SETTINGS_SIZE           (SETTINGS_DATA_SIZE - 3)
+#define SETTINGS_CHUNK_SIZE     8
+#define SETTINGS_CHUNKS_NUM     ((SETTINGS_SIZE + SETTINGS_CHUNK_SIZE - 1) / SETTINGS_CHUNK_SIZE)
+#define SETTINGS_WRITE_ROUNDS   4       // CONTROLLER CYCLES TO RESEND REJECTED CHUNKS
+#define SETTINGS_CORRECTORS_MAX 2
+#define SETTINGS_POSITIONS_MAX  16
+
+#define READ_SETTINGS_CODE      0x12
+#define EEPROM_WRITE_CODE       0x10
+#define EEPROM_READ_CODE        0x11
+#define EXT_POSITIONS_CODE      0x17
+#define CLEAR_ERRORS_CODE       0x18
+
+// Settings block of controller as it is stored in its EEPROM. Position i of corrector is
+// used between ADC values i - 1 and i, so last position has no ADC value. Positions are
+// in units of positionMult.
+struct ControllerSettings
+{
+    uint8_t correctorsNum;
+    uint8_t positionsNum;
+    uint8_t positionMult;
+    uint8_t correctorAddresses[SETTINGS_CORRECTORS_MAX];
+    int8_t startPositions[SETTINGS_CORRECTORS_MAX];
+    uint8_t adcValues[SETTINGS_POSITIONS_MAX - 1];
+    int8_t positions[SETTINGS_CORRECTORS_MAX][SETTINGS_POSITIONS_MAX];
+
+    static ControllerSettings fromBytes(const QByteArray &settings);
+
+    QByteArray toBytes() const;
+};
+
+// EMPTY STRING IF SETTINGS BLOCK CAN BE SENT TO CONTROLLER
+QString checkSettings(const QByteArray &settings);
+
+QByteArray defaultSettings();
+
+// INDEXES OF 8 BYTES CHUNKS WHICH DIFFER, ALL IF OLD BLOCK IS UNKNOWN (EMPTY)
+QVector<int> changedSettingsChunks(const QByteArray &oldSettings, const QByteArray &newSettings);
+
+// 11 BYTES CONTROLLER COMMAND: SYNC, CODE, DATA (PADDED BY ZEROS), CHECKSUM
+QByteArray commandFrame(uint8_t code, const QByteArray &data = QByteArray());
+
+// 0x17 COMMAND, POSITIONS ARE NOT DIVIDED BY MULT
+QByteArray extPositionsFrame(int16_t corrector1, int16_t corrector2, bool extControl);
+
+void placeCommandChecksum(QByteArray *frame);
+
+#endif // CONTROLLER_SETTINGS_H
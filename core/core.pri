@@ -0,0 +1,16 @@
+# Included by projects linked with lin_core static library
+
+QT       += serialport
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+win32:CONFIG(release, debug|release): CORE_LIB_DIR = $$OUT_PWD/../core/release
+else:win32:CONFIG(debug, debug|release): CORE_LIB_DIR = $$OUT_PWD/../core/debug
+else: CORE_LIB_DIR = $$OUT_PWD/../core
+
+LIBS += -L$$CORE_LIB_DIR -llin_core
+
+win32-g++: PRE_TARGETDEPS += $$CORE_LIB_DIR/liblin_core.a
+else:win32: PRE_TARGETDEPS += $$CORE_LIB_DIR/lin_core.lib
+else: PRE_TARGETDEPS += $$CORE_LIB_DIR/liblin_core.a
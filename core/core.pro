@@ -0,0 +1,55 @@
+#-------------------------------------------------
+#
+# Protocol, hex and settings code shared by GUI, CLI and emulator
+#
+#-------------------------------------------------
+
+QT       += core
+QT       += serialport
+QT       -= gui
+
+TARGET = lin_core
+TEMPLATE = lib
+
+CONFIG += staticlib c++11
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    hex_converter.cpp \
+    flash_image.cpp \
+    lin_frame_decoder.cpp \
+    lin_transaction.cpp \
+    rtt_estimator.cpp \
+    serial_worker.cpp \
+    lin_link.cpp \
+    flash_session.cpp \
+    controller_settings.cpp \
+    controller_session.cpp \
+    flash_job.cpp \
+    flash_write_plan.cpp \
+    device_snapshot_cache.cpp \
+    flash_journal.cpp \
+    ext_position_streamer.cpp \
+    telemetry_recorder.cpp \
+    telemetry_replayer.cpp
+
+HEADERS += \
+    hex_converter.h \
+    flash_image.h \
+    lin_frame_decoder.h \
+    lin_transaction.h \
+    rtt_estimator.h \
+    serial_worker.h \
+    lin_link.h \
+    flash_session.h \
+    controller_settings.h \
+    frame_layout.h \
+    controller_session.h \
+    flash_job.h \
+    flash_write_plan.h \
+    device_snapshot_cache.h \
+    flash_journal.h \
+    ext_position_streamer.h \
+    telemetry_recorder.h \
+    telemetry_replayer.h
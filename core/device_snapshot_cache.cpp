@@ -0,0 +1,91 @@
+#include "device_snapshot_cache.h"
+#include "hex_converter.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+
+QMutex &cacheMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+}
+
+DeviceSnapshotCache::DeviceSnapshotCache(const QString &directory) :
+    m_directory(directory)
+{
+}
+
+QString DeviceSnapshotCache::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/snapshots";
+}
+
+QString DeviceSnapshotCache::deviceKey(const char *configRow)
+{
+    uint16_t words[FLASH_ROW_WORDS];
+    for (int i = 0; i < FLASH_ROW_WORDS; i++)
+        words[i] = (static_cast<uint8_t>(configRow[i * 2]) | (static_cast<uint8_t>(configRow[i * 2 + 1]) << 8)) & 0x3FFF;
+    if ((words[0] == 0x3FFF) && (words[1] == 0x3FFF) && (words[2] == 0x3FFF) && (words[3] == 0x3FFF))
+        return QString();
+    return QString("%1_%2%3%4%5").arg(words[6], 4, 16, QChar('0'))
+            .arg(words[0], 4, 16, QChar('0')).arg(words[1], 4, 16, QChar('0'))
+            .arg(words[2], 4, 16, QChar('0')).arg(words[3], 4, 16, QChar('0'));
+}
+
+bool DeviceSnapshotCache::load(const QString &key, FlashImage *snapshot) const
+{
+    QMutexLocker locker(&cacheMutex());
+    return loadFile(key, snapshot);
+}
+
+bool DeviceSnapshotCache::loadFile(const QString &key, FlashImage *snapshot) const
+{
+    snapshot->clear();
+    if (key.isEmpty())
+        return false;
+    QFile file(fileName(key));
+    if (!file.open(QFile::ReadOnly))
+        return false;
+    QByteArray contents = file.readAll();
+    return hexFileToImage(contents.constData(), contents.size(), snapshot).isEmpty() && !snapshot->isEmpty();
+}
+
+bool DeviceSnapshotCache::update(const QString &key, const FlashImage &rows, const QString &previousKey)
+{
+    if (key.isEmpty())
+        return false;
+    QMutexLocker locker(&cacheMutex());
+    FlashImage snapshot;
+    loadFile(previousKey, &snapshot);
+    if ((previousKey != key) && !previousKey.isEmpty())
+        QFile::remove(fileName(previousKey));
+    for (FlashImage::Row row : rows)
+        snapshot.setData(row.address, row.data, FLASH_ROW_SIZE, false);
+
+    QDir().mkpath(m_directory);
+    QSaveFile file(fileName(key));
+    if (!file.open(QFile::WriteOnly))
+        return false;
+    file.write(imageToHexFile(snapshot));
+    return file.commit();
+}
+
+void DeviceSnapshotCache::remove(const QString &key)
+{
+    QMutexLocker locker(&cacheMutex());
+    if (!key.isEmpty())
+        QFile::remove(fileName(key));
+}
+
+QString DeviceSnapshotCache::fileName(const QString &key) const
+{
+    return m_directory + "/" + key + ".hex";
+}
@@ -0,0 +1,43 @@
+#ifndef DEVICE_SNAPSHOT_CACHE_H
+#define DEVICE_SNAPSHOT_CACHE_H
+
+#include <QString>
+
+#include "flash_image.h"
+
+// Last known flash contents of each device, one hex file per device in cache directory.
+// Device is identified by USER ID (0x8000 - 0x8003) and DEVICE ID (0x8006) words, so
+// boards without programmed USER ID are not cached. Files are accessed under one lock
+// shared by all caches, so parallel jobs whose boards share a key do not mix one file.
+class DeviceSnapshotCache
+{
+public:
+    explicit DeviceSnapshotCache(const QString &directory = defaultDirectory());
+
+    QString directory() const { return m_directory; }
+
+    static QString defaultDirectory();
+
+    // CONFIG ROW AS READ FROM DEVICE, EMPTY KEY IF USER ID IS ERASED
+    static QString deviceKey(const char *configRow);
+
+    bool load(const QString &key, FlashImage *snapshot) const;
+
+    // ADDS PRESENT ROWS OF IMAGE TO SNAPSHOT OF DEVICE. DIFFERENT previousKey MEANS DEVICE GOT
+    // NEW KEY: ITS SNAPSHOT MOVES TO key AND REPLACES ONE STORED THERE
+    bool update(const QString &key, const FlashImage &rows, const QString &previousKey);
+
+    bool update(const QString &key, const FlashImage &rows) { return update(key, rows, key); }
+
+    void remove(const QString &key);
+
+private:
+    QString m_directory;
+
+    QString fileName(const QString &key) const;
+
+    // CALLER HOLDS LOCK
+    bool loadFile(const QString &key, FlashImage *snapshot) const;
+};
+
+#endif // DEVICE_SNAPSHOT_CACHE_H
@@ -0,0 +1,97 @@
+#include "ext_position_streamer.h"
+#include "controller_settings.h"
+#include "controller_session.h"
+#include "frame_layout.h"
+
+ExtPositionStreamer::ExtPositionStreamer(LinLink *link, QObject *parent) :
+    QObject(parent),
+    m_link(link),
+    m_hasPending(false),
+    m_newCycle(true),
+    m_waitFeedback(false),
+    m_coalesced(0)
+{
+    m_sent.values[0] = m_sent.values[1] = 0;
+    m_sent.extControl = false;
+    m_pending = m_sent;
+    connect(m_link, &LinLink::frameReceived, this, &ExtPositionStreamer::frameReceived);
+}
+
+ExtPositionStreamer::~ExtPositionStreamer()
+{
+    delete m_reply;
+}
+
+void ExtPositionStreamer::setTarget(int16_t corrector1, int16_t corrector2, bool extControl)
+{
+    if (m_hasPending)
+        m_coalesced++;
+    m_pending.values[0] = corrector1;
+    m_pending.values[1] = corrector2;
+    m_pending.extControl = extControl;
+    m_hasPending = true;
+    if (!isBusy() && m_newCycle)
+        sendPending();
+}
+
+void ExtPositionStreamer::frameReceived(const LinFrame &frame)
+{
+    if ((frame.protocol != LinFrameDecoder::ControllerProtocol) || (frame.code != VALUES_FRAME_CODE))
+        return;
+    m_newCycle = true;
+
+    // WRITTEN VALUES ARE BYTES 7..10 OF VALUES DATA
+    const uint8_t *data = frame.bytes + 2;
+    int16_t written[2];
+    written[0] = static_cast<int16_t>(data[7] | (data[8] << 8));
+    written[1] = static_cast<int16_t>(data[9] | (data[10] << 8));
+    if (m_waitFeedback && m_sent.extControl && (written[0] == m_sent.values[0]) && (written[1] == m_sent.values[1]))
+    {
+        m_waitFeedback = false;
+        emit latencyMeasured(static_cast<int>(m_sentTime.elapsed()));
+    }
+
+    if (!isBusy() && m_hasPending)
+        sendPending();
+}
+
+void ExtPositionStreamer::replySent()
+{
+    m_sentTime.start();
+    m_waitFeedback = true;
+}
+
+void ExtPositionStreamer::replyFinished()
+{
+    LinReply *reply = m_reply;
+    m_reply = 0;
+    if (reply == 0)
+        return;
+    if (reply->error() != LinReply::NoError)
+    {
+        m_waitFeedback = false;
+        emit failed(ControllerSession::errorString(reply->error()));
+    }
+    else if (AckLayout::ErrorCode::read(reply->frame().bytes) != 0)
+    {
+        m_waitFeedback = false;
+        emit failed(QString("Controller sent error code %1").arg(AckLayout::ErrorCode::read(reply->frame().bytes)));
+    }
+    reply->deleteLater();
+    if (m_hasPending && m_newCycle)
+        sendPending();
+}
+
+void ExtPositionStreamer::sendPending()
+{
+    if (!m_link->isOpen())
+        return;
+    QByteArray frame = extPositionsFrame(m_pending.values[0], m_pending.values[1], m_pending.extControl);
+
+    m_sent = m_pending;
+    m_hasPending = false;
+    m_newCycle = false;
+    m_reply = m_link->submit(LinRequest(&extPositionsCommand, frame));
+    connect(m_reply, &LinReply::sent, this, &ExtPositionStreamer::replySent);
+    connect(m_reply, &LinReply::finished, this, &ExtPositionStreamer::replyFinished);
+}
@@ -0,0 +1,72 @@
+#ifndef EXT_POSITION_STREAMER_H
+#define EXT_POSITION_STREAMER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPointer>
+
+#include "lin_link.h"
+
+// Latest-value-wins streaming of external corrector positions (0x17). Never blocks: one
+// command is in flight at most, new targets only replace pending one, and next command
+// waits for next values frame, so controller gets at most one per cycle. Latency is time
+// from command write to values frame which shows sent positions as written values.
+class ExtPositionStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ExtPositionStreamer(LinLink *link, QObject *parent = 0);
+    ~ExtPositionStreamer();
+
+    void setTarget(int16_t corrector1, int16_t corrector2, bool extControl);
+
+    bool isBusy() const { return m_reply != 0; }
+
+    // TARGETS REPLACED BEFORE THEY WERE SENT
+    int coalesced() const { return m_coalesced; }
+
+signals:
+
+    void latencyMeasured(int latency);
+
+    void failed(const QString &error);
+
+private slots:
+
+    void frameReceived(const LinFrame &frame);
+
+    void replySent();
+
+    void replyFinished();
+
+private:
+    struct Target
+    {
+        int16_t values[2];
+        bool extControl;
+    };
+
+    LinLink *m_link;
+
+    QPointer<LinReply> m_reply;
+
+    Target m_sent;
+
+    Target m_pending;
+
+    bool m_hasPending;
+
+    // VALUES FRAME CAME SINCE LAST SEND
+    bool m_newCycle;
+
+    bool m_waitFeedback;
+
+    QElapsedTimer m_sentTime;
+
+    int m_coalesced;
+
+    void sendPending();
+};
+
+#endif // EXT_POSITION_STREAMER_H
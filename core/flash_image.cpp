@@ -0,0 +1,128 @@
+#include "flash_image.h"
+
+#include <string.h>
+
+FlashImage::FlashImage(int32_t programWords) :
+    m_programRows((programWords + FLASH_ROW_WORDS - 1) / FLASH_ROW_WORDS),
+    m_rowsNum(m_programRows + FLASH_CONFIG_WORDS / FLASH_ROW_WORDS),
+    m_presentRowsNum(0),
+    m_data(m_rowsNum * FLASH_ROW_SIZE, static_cast<char>(0xFF)),
+    m_presentRows(m_rowsNum),
+    m_dirtyRows(m_rowsNum)
+{
+}
+
+void FlashImage::clear()
+{
+    m_data.fill(static_cast<char>(0xFF));
+    m_presentRows.fill(false);
+    m_dirtyRows.fill(false);
+    m_presentRowsNum = 0;
+}
+
+bool FlashImage::setData(int32_t address, const char *data, int size, bool dirty)
+{
+    // ONLY FULL WORDS ARE STORED
+    int wordsNum = size / 2;
+    if (wordsNum <= 0)
+        return true;
+    int firstIndex = rowIndex(address);
+    int lastIndex = rowIndex(address + wordsNum - 1);
+    if ((firstIndex < 0) || (lastIndex < 0) || ((lastIndex - firstIndex) != ((address + wordsNum - 1) / FLASH_ROW_WORDS - address / FLASH_ROW_WORDS)))
+        return false;
+
+    int offset = firstIndex * FLASH_ROW_SIZE + (address % FLASH_ROW_WORDS) * 2;
+    memcpy(m_data.data() + offset, data, wordsNum * 2);
+    for (int i = firstIndex; i <= lastIndex; i++)
+    {
+        if (!m_presentRows.testBit(i))
+        {
+            m_presentRows.setBit(i);
+            m_presentRowsNum++;
+        }
+        m_dirtyRows.setBit(i, dirty);
+    }
+    return true;
+}
+
+bool FlashImage::isRowPresent(int32_t address) const
+{
+    int index = rowIndex(address);
+    return (index >= 0) && m_presentRows.testBit(index);
+}
+
+bool FlashImage::isRowDirty(int32_t address) const
+{
+    int index = rowIndex(address);
+    return (index >= 0) && m_dirtyRows.testBit(index);
+}
+
+void FlashImage::setRowDirty(int32_t address, bool dirty)
+{
+    int index = rowIndex(address);
+    if (index >= 0)
+        m_dirtyRows.setBit(index, dirty);
+}
+
+const char *FlashImage::rowData(int32_t address) const
+{
+    int index = rowIndex(address);
+    if (index < 0)
+        return 0;
+    return m_data.constData() + index * FLASH_ROW_SIZE;
+}
+
+bool FlashImage::isSameRow(int32_t address, const char *expected, const char *actual)
+{
+    for (int i = 0; i < FLASH_ROW_WORDS; i++)
+    {
+        int32_t wordAddress = address + i;
+        if ((wordAddress == FLASH_CONFIG_ADDRESS + 5) || (wordAddress == FLASH_CONFIG_ADDRESS + 6))
+            continue;
+        uint16_t expectedWord = static_cast<uint8_t>(expected[i * 2]) | (static_cast<uint8_t>(expected[i * 2 + 1]) << 8);
+        uint16_t actualWord = static_cast<uint8_t>(actual[i * 2]) | (static_cast<uint8_t>(actual[i * 2 + 1]) << 8);
+        if ((expectedWord & FLASH_WORD_MASK) != (actualWord & FLASH_WORD_MASK))
+            return false;
+    }
+    return true;
+}
+
+uint16_t FlashImage::word(int32_t address) const
+{
+    int index = rowIndex(address);
+    if (index < 0)
+        return 0xFFFF;
+    const uint8_t *bytes = reinterpret_cast<const uint8_t*>(m_data.constData() + index * FLASH_ROW_SIZE + (address % FLASH_ROW_WORDS) * 2);
+    return bytes[0] + bytes[1] * 256;
+}
+
+int FlashImage::rowIndex(int32_t address) const
+{
+    if ((address >= 0) && (address < (m_programRows * FLASH_ROW_WORDS)))
+        return address / FLASH_ROW_WORDS;
+    if ((address >= FLASH_CONFIG_ADDRESS) && (address < (FLASH_CONFIG_ADDRESS + FLASH_CONFIG_WORDS)))
+        return m_programRows + (address - FLASH_CONFIG_ADDRESS) / FLASH_ROW_WORDS;
+    return -1;
+}
+
+int32_t FlashImage::rowAddress(int index) const
+{
+    if (index < m_programRows)
+        return index * FLASH_ROW_WORDS;
+    return FLASH_CONFIG_ADDRESS + (index - m_programRows) * FLASH_ROW_WORDS;
+}
+
+int FlashImage::nextPresentRow(int index) const
+{
+    while ((index < m_rowsNum) && !m_presentRows.testBit(index))
+        index++;
+    return index;
+}
+
+FlashImage::Row FlashImage::row(int index) const
+{
+    Row currentRow;
+    currentRow.address = rowAddress(index);
+    currentRow.data = m_data.constData() + index * FLASH_ROW_SIZE;
+    return currentRow;
+}
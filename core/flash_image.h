@@ -0,0 +1,95 @@
+#ifndef FLASH_IMAGE_H
+#define FLASH_IMAGE_H
+
+#include <QByteArray>
+#include <QBitArray>
+
+#define FLASH_ROW_WORDS         16
+#define FLASH_ROW_SIZE          (FLASH_ROW_WORDS * 2)
+
+#define FLASH_PROGRAM_WORDS     0x800   // PIC12F1822
+#define FLASH_CONFIG_ADDRESS    0x8000
+#define FLASH_CONFIG_WORDS      0x20
+#define FLASH_WORD_MASK         0x3FFF  // PIC12F1822 PROGRAM WORD IS 14 BITS
+
+// Program memory and config region (USER ID, DEVICE ID, CONFIGURATION WORDS) of one device.
+// Both regions are preallocated and filled by 0xFF, rows (16 words) are marked present when
+// some data was written to them and dirty until they are written to the device.
+class FlashImage
+{
+public:
+    struct Row
+    {
+        int32_t address;
+        const char *data;   // FLASH_ROW_SIZE BYTES, LOW BYTE OF WORD FIRST
+    };
+
+    // ITERATES ONLY PRESENT ROWS, IN ADDRESS ORDER
+    class RowIterator
+    {
+    public:
+        Row operator*() const { return m_image->row(m_index); }
+        RowIterator &operator++() { m_index = m_image->nextPresentRow(m_index + 1); return *this; }
+        bool operator!=(const RowIterator &other) const { return m_index != other.m_index; }
+        bool operator==(const RowIterator &other) const { return m_index == other.m_index; }
+
+    private:
+        friend class FlashImage;
+        RowIterator(const FlashImage *image, int index) : m_image(image), m_index(index) {}
+
+        const FlashImage *m_image;
+        int m_index;
+    };
+
+    explicit FlashImage(int32_t programWords = FLASH_PROGRAM_WORDS);
+
+    void clear();
+
+    bool isEmpty() const { return m_presentRowsNum == 0; }
+
+    int rowsCount() const { return m_presentRowsNum; }
+
+    bool contains(int32_t address) const { return rowIndex(address) >= 0; }
+
+    bool setData(int32_t address, const char *data, int size, bool dirty = true);
+
+    bool isRowPresent(int32_t address) const;
+
+    bool isRowDirty(int32_t address) const;
+
+    void setRowDirty(int32_t address, bool dirty);
+
+    const char *rowData(int32_t address) const;
+
+    uint16_t word(int32_t address) const;
+
+    RowIterator begin() const { return RowIterator(this, nextPresentRow(0)); }
+
+    RowIterator end() const { return RowIterator(this, m_rowsNum); }
+
+    // COMPARES 14 BIT WORDS OF ROW DATA, DEVICE ID AND REVISION ARE SKIPPED
+    static bool isSameRow(int32_t address, const char *expected, const char *actual);
+
+private:
+    int32_t m_programRows;
+
+    int32_t m_rowsNum;
+
+    int m_presentRowsNum;
+
+    QByteArray m_data;
+
+    QBitArray m_presentRows;
+
+    QBitArray m_dirtyRows;
+
+    int rowIndex(int32_t address) const;
+
+    int32_t rowAddress(int index) const;
+
+    int nextPresentRow(int index) const;
+
+    Row row(int index) const;
+};
+
+#endif // FLASH_IMAGE_H
@@ -0,0 +1,78 @@
+#include "flash_job.h"
+#include "flash_session.h"
+#include "lin_link.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+FlashJob::FlashJob(int index, const QString &portName, int baudRate, const FlashImage &image, bool verify, QObject *parent) :
+    QObject(parent),
+    m_index(index),
+    m_portName(portName),
+    m_baudRate(baudRate),
+    m_image(image),
+    m_verify(verify),
+    m_resume(false),
+    m_session(0),
+    m_aborted(false)
+{
+    setAutoDelete(false);
+}
+
+void FlashJob::run()
+{
+    QElapsedTimer time;
+    time.start();
+    FlashWritePlan plan(m_image);
+
+    LinLink link;
+    FlashSession session(&link);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_aborted)
+        {
+            emit finished(m_index, false, "Aborted", time.elapsed(), 0);
+            return;
+        }
+        m_session = &session;
+    }
+
+    QString result;
+    bool ok = false;
+    if (!link.open(m_portName, m_baudRate))
+        result = QString("Can't open port %1").arg(m_portName);
+    else
+    {
+        DeviceSnapshotCache cache(m_snapshotDirectory);
+        if (!m_snapshotDirectory.isEmpty())
+            session.setSnapshotCache(&cache);
+        FlashJournal journal(m_resume ? FlashJournal::defaultFileName(m_portName) : QString());
+        session.setJournal(&journal);
+        LinReply::Error error = session.applySnapshot(m_image, &plan);
+        connect(&session, &FlashSession::progress, [this](int done, int total) { emit progress(m_index, done, total); });
+        QVector<int32_t> mismatches;
+        if (error == LinReply::NoError)
+            error = m_verify ? session.writeVerified(m_image, plan, &mismatches) : session.write(m_image, plan);
+        if (error != LinReply::NoError)
+            result = QString("Write at %1: %2").arg(session.errorAddress(), 4, 16, QChar('0')).arg(FlashSession::errorString(error));
+        else if (!mismatches.isEmpty())
+            result = QString("%1 rows differ, first at %2").arg(mismatches.size()).arg(mismatches.first(), 4, 16, QChar('0'));
+        else
+            ok = true;
+        link.close();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_session = 0;
+    }
+    emit finished(m_index, ok, ok ? QString("OK") : result, time.elapsed(), ok ? plan.bytes() : 0);
+}
+
+void FlashJob::abort()
+{
+    QMutexLocker locker(&m_mutex);
+    m_aborted = true;
+    if (m_session != 0)
+        m_session->abort();
+}
@@ -0,0 +1,66 @@
+#ifndef FLASH_JOB_H
+#define FLASH_JOB_H
+
+#include <QObject>
+#include <QRunnable>
+#include <QMutex>
+#include <QString>
+
+#include "flash_image.h"
+
+class FlashSession;
+
+// Write (and optional verify) of one image over one port, for QThreadPool. Each job owns
+// its own link, so failed or slow port does not stall others. Signals are emitted from
+// pool thread. Image is implicitly shared copy and is never modified.
+class FlashJob : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    FlashJob(int index, const QString &portName, int baudRate, const FlashImage &image, bool verify, QObject *parent = 0);
+
+    int index() const { return m_index; }
+
+    QString portName() const { return m_portName; }
+
+    // EMPTY DIRECTORY DISABLES DIFFERENTIAL WRITE, SEE DeviceSnapshotCache
+    void setSnapshotDirectory(const QString &directory) { m_snapshotDirectory = directory; }
+
+    // JOURNAL OF PORT CONTINUES INTERRUPTED WRITE, SEE FlashJournal. OFF BY DEFAULT
+    void setResume(bool resume) { m_resume = resume; }
+
+    virtual void run();
+
+    // CAN BE CALLED FROM ANY THREAD, JOB SUBMITS NO MORE REQUESTS AFTER IT
+    void abort();
+
+signals:
+
+    void progress(int index, int done, int total);
+
+    void finished(int index, bool ok, const QString &result, qint64 elapsed, int bytes);
+
+private:
+    int m_index;
+
+    QString m_portName;
+
+    int m_baudRate;
+
+    FlashImage m_image;
+
+    bool m_verify;
+
+    QString m_snapshotDirectory;
+
+    bool m_resume;
+
+    QMutex m_mutex;
+
+    FlashSession *m_session;
+
+    bool m_aborted;
+};
+
+#endif // FLASH_JOB_H
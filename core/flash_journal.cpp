@@ -0,0 +1,137 @@
+#include "flash_journal.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegExp>
+#include <QStandardPaths>
+
+FlashJournal::FlashJournal(const QString &fileName) :
+    m_file(fileName),
+    m_resumedRows(0)
+{
+}
+
+void FlashJournal::setFileName(const QString &fileName)
+{
+    close();
+    m_file.setFileName(fileName);
+    m_resumedRows = 0;
+}
+
+QString FlashJournal::defaultFileName(const QString &portName)
+{
+    QString name = portName;
+    name.replace(QRegExp("[^A-Za-z0-9]"), "_");
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/journal/" + name + ".journal";
+}
+
+QByteArray FlashJournal::imageHash(const FlashImage &image)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (FlashImage::Row row : image)
+    {
+        char addressBytes[2] = {static_cast<char>(row.address & 0xFF), static_cast<char>((row.address >> 8) & 0xFF)};
+        hash.addData(addressBytes, 2);
+        hash.addData(row.data, FLASH_ROW_SIZE);
+    }
+    return hash.result().toHex();
+}
+
+QByteArray FlashJournal::rangeHash(int32_t startAddress, int32_t endAddress)
+{
+    return QString("%1:%2").arg(startAddress, 4, 16, QChar('0')).arg(endAddress, 4, 16, QChar('0')).toLatin1();
+}
+
+QString FlashJournal::deviceIdentity(const char *configRow)
+{
+    QString identity;
+    for (int i = 0; i < 7; i++)
+    {
+        if ((i == 4) || (i == 5))
+            continue;
+        uint16_t word = (static_cast<uint8_t>(configRow[i * 2]) | (static_cast<uint8_t>(configRow[i * 2 + 1]) << 8)) & 0x3FFF;
+        identity += QString("%1").arg(word, 4, 16, QChar('0'));
+    }
+    return identity;
+}
+
+QVector<int32_t> FlashJournal::begin(Operation operation, const QByteArray &hash, const QString &device, FlashImage *image)
+{
+    close();
+    m_resumedRows = 0;
+    QVector<int32_t> rows;
+    if (m_file.fileName().isEmpty())
+        return rows;
+
+    QJsonObject header;
+    header["operation"] = (operation == Read) ? "read" : "write";
+    header["hash"] = QString::fromLatin1(hash);
+    header["device"] = device;
+
+    if (m_file.open(QFile::ReadOnly))
+    {
+        QJsonObject previous = QJsonDocument::fromJson(m_file.readLine()).object();
+        while ((previous == header) && !m_file.atEnd())
+        {
+            QList<QByteArray> fields = m_file.readLine().trimmed().split(' ');
+            bool ok;
+            int32_t address = fields.at(0).toInt(&ok, 16);
+            if (!ok)
+                break;
+            if (operation == Read)
+            {
+                QByteArray data = (fields.size() > 1) ? QByteArray::fromHex(fields.at(1)) : QByteArray();
+                // LAST LINE CAN BE CUT BY POWER LOSS
+                if ((data.size() != FLASH_ROW_SIZE) || (image == 0))
+                    break;
+                image->setData(address, data.constData(), FLASH_ROW_SIZE, false);
+            }
+            rows.append(address);
+        }
+        m_file.close();
+        if (previous != header)
+            rows.clear();
+    }
+    m_resumedRows = rows.size();
+
+    QDir().mkpath(QFileInfo(m_file).absolutePath());
+    if (!m_file.open(QFile::WriteOnly | QFile::Truncate))
+        return rows;
+    // REWRITTEN WITHOUT CUT LINE, IF ANY
+    m_file.write(QJsonDocument(header).toJson(QJsonDocument::Compact) + "\n");
+    for (int32_t address : rows)
+    {
+        QByteArray line = QByteArray::number(address, 16);
+        if (operation == Read)
+            line += " " + QByteArray(image->rowData(address), FLASH_ROW_SIZE).toHex();
+        m_file.write(line + "\n");
+    }
+    m_file.flush();
+    return rows;
+}
+
+void FlashJournal::confirm(int32_t address, const char *data)
+{
+    if (!m_file.isOpen())
+        return;
+    QByteArray line = QByteArray::number(address, 16);
+    if (data != 0)
+        line += " " + QByteArray(data, FLASH_ROW_SIZE).toHex();
+    m_file.write(line + "\n");
+    m_file.flush();
+}
+
+void FlashJournal::finish()
+{
+    if (m_file.isOpen())
+        m_file.remove();
+}
+
+void FlashJournal::close()
+{
+    if (m_file.isOpen())
+        m_file.close();
+}
@@ -0,0 +1,63 @@
+#ifndef FLASH_JOURNAL_H
+#define FLASH_JOURNAL_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include "flash_image.h"
+
+// Record of rows confirmed by interrupted read or write, so next attempt continues from first
+// unconfirmed row. First line is JSON header (operation, hash of image or range, device
+// identity), then one line per confirmed row: hex word address and, for read, row data.
+// Journal of other operation, image or device is discarded. File is removed when operation
+// completes. Boards without USER ID are told apart only by port the journal belongs to.
+class FlashJournal
+{
+public:
+    enum Operation
+    {
+        Read,
+        Write
+    };
+
+    explicit FlashJournal(const QString &fileName = QString());
+
+    QString fileName() const { return m_file.fileName(); }
+
+    // EMPTY NAME DISABLES JOURNAL
+    void setFileName(const QString &fileName);
+
+    static QString defaultFileName(const QString &portName);
+
+    // ALL PRESENT ROWS, SO RESUME DOES NOT DEPEND ON WRITE PLAN
+    static QByteArray imageHash(const FlashImage &image);
+
+    static QByteArray rangeHash(int32_t startAddress, int32_t endAddress);
+
+    // USER ID AND DEVICE ID WORDS OF CONFIG ROW
+    static QString deviceIdentity(const char *configRow);
+
+    // RETURNS ROWS CONFIRMED BY PREVIOUS MATCHING ATTEMPT, FOR READ THEIR DATA IS PUT TO IMAGE
+    QVector<int32_t> begin(Operation operation, const QByteArray &hash, const QString &device, FlashImage *image = 0);
+
+    // DATA ONLY FOR READ
+    void confirm(int32_t address, const char *data = 0);
+
+    // OPERATION IS DONE, JOURNAL IS REMOVED
+    void finish();
+
+    // OPERATION FAILED, JOURNAL IS KEPT FOR NEXT ATTEMPT
+    void close();
+
+    bool isActive() const { return m_file.isOpen(); }
+
+    int resumedRows() const { return m_resumedRows; }
+
+private:
+    QFile m_file;
+
+    int m_resumedRows;
+};
+
+#endif // FLASH_JOURNAL_H
@@ -0,0 +1,506 @@
+#include "flash_session.h"
+#include "frame_layout.h"
+
+#include <string.h>
+
+FlashSession::FlashSession(LinLink *link, QObject *parent) :
+    QObject(parent),
+    m_link(link),
+    m_errorAddress(-1),
+    m_cache(0),
+    m_sampleRows(FLASH_SAMPLE_ROWS),
+    m_journal(0),
+    m_aborted(0)
+{
+}
+
+void FlashSession::abort()
+{
+    m_aborted.storeRelease(1);
+    m_link->abortAll();
+}
+
+void FlashSession::setSnapshotCache(DeviceSnapshotCache *cache, int sampleRows)
+{
+    m_cache = cache;
+    m_sampleRows = sampleRows;
+    m_deviceKey.clear();
+}
+
+LinReply::Error FlashSession::read(int32_t startAddress, int32_t endAddress, FlashImage *image)
+{
+    QVector<int32_t> rows;
+    for (int32_t address = startAddress; address + FLASH_ROW_WORDS - 1 <= endAddress; address += FLASH_ROW_WORDS)
+        rows.append(address);
+
+    FlashImage readImage;
+    LinReply::Error error = beginJournal(FlashJournal::Read, FlashJournal::rangeHash(startAddress, endAddress), &rows, &readImage);
+    if (error != LinReply::NoError)
+        return error;
+    for (FlashImage::Row row : readImage)
+    {
+        image->setData(row.address, row.data, FLASH_ROW_SIZE, false);
+        emit rowRead(row.address, row.data);
+    }
+    error = readRows(rows, &readImage);
+    endJournal(error == LinReply::NoError);
+    for (FlashImage::Row row : readImage)
+        image->setData(row.address, row.data, FLASH_ROW_SIZE, false);
+    if ((error != LinReply::NoError) || (m_cache == 0))
+        return error;
+
+    QString key;
+    if (readImage.isRowPresent(FLASH_CONFIG_ADDRESS))
+        key = DeviceSnapshotCache::deviceKey(readImage.rowData(FLASH_CONFIG_ADDRESS));
+    else
+        error = readDeviceKey(&key, &readImage);
+    if (error == LinReply::NoError)
+        m_cache->update(key, readImage);
+    return error;
+}
+
+LinReply::Error FlashSession::readDeviceKey(QString *key, FlashImage *configRow)
+{
+    FlashImage readImage;
+    if (configRow == 0)
+        configRow = &readImage;
+    key->clear();
+    LinReply::Error error = readRows(QVector<int32_t>() << FLASH_CONFIG_ADDRESS, configRow);
+    if (error == LinReply::NoError)
+        *key = DeviceSnapshotCache::deviceKey(configRow->rowData(FLASH_CONFIG_ADDRESS));
+    return error;
+}
+
+LinReply::Error FlashSession::applySnapshot(const FlashImage &image, FlashWritePlan *plan)
+{
+    m_deviceKey.clear();
+    m_deviceConfigRow.clear();
+    if (m_cache == 0)
+        return LinReply::NoError;
+
+    QString key;
+    FlashImage deviceRows;
+    LinReply::Error error = readDeviceKey(&key, &deviceRows);
+    if (error == LinReply::NoError)
+        m_deviceConfigRow = QByteArray(deviceRows.rowData(FLASH_CONFIG_ADDRESS), FLASH_ROW_SIZE);
+    FlashImage snapshot;
+    if ((error != LinReply::NoError) || !m_cache->load(key, &snapshot))
+    {
+        m_deviceKey = key;
+        return error;
+    }
+
+    // SAMPLES ARE TAKEN FROM ROWS WHICH WOULD BE SKIPPED, CONFIG ROW IS ALREADY READ
+    QVector<int32_t> unchanged;
+    for (int32_t address : plan->rows())
+    {
+        if ((address != FLASH_CONFIG_ADDRESS) && snapshot.isRowPresent(address)
+                && FlashImage::isSameRow(address, image.rowData(address), snapshot.rowData(address)))
+            unchanged.append(address);
+    }
+    QVector<int32_t> samples;
+    int samplesNum = qMin(m_sampleRows, unchanged.size());
+    for (int i = 0; i < samplesNum; i++)
+        samples.append(unchanged.at(samplesNum > 1 ? i * (unchanged.size() - 1) / (samplesNum - 1) : 0));
+    error = readRows(samples, &deviceRows);
+    if (error != LinReply::NoError)
+        return error;
+
+    for (FlashImage::Row row : deviceRows)
+    {
+        if (snapshot.isRowPresent(row.address) && !FlashImage::isSameRow(row.address, snapshot.rowData(row.address), row.data))
+        {
+            // DEVICE WAS CHANGED BY SOMEONE ELSE, WRITE ALL
+            m_cache->remove(key);
+            m_deviceKey = key;
+            return LinReply::NoError;
+        }
+    }
+    plan->excludeUnchanged(image, snapshot);
+    m_deviceKey = key;
+    return LinReply::NoError;
+}
+
+LinReply::Error FlashSession::write(FlashImage *image)
+{
+    FlashWritePlan plan(*image);
+    LinReply::Error error = applySnapshot(*image, &plan);
+    if (error != LinReply::NoError)
+        return error;
+    return write(image, plan);
+}
+
+LinReply::Error FlashSession::write(FlashImage *image, const FlashWritePlan &plan)
+{
+    LinReply::Error error = write(*image, plan);
+    markWritten(image);
+    return error;
+}
+
+LinReply::Error FlashSession::write(const FlashImage &image)
+{
+    FlashWritePlan plan(image);
+    LinReply::Error error = applySnapshot(image, &plan);
+    if (error != LinReply::NoError)
+        return error;
+    return write(image, plan);
+}
+
+LinReply::Error FlashSession::write(const FlashImage &image, const FlashWritePlan &plan)
+{
+    m_unconfirmedRows = plan.rows();
+    QVector<int32_t> rows = plan.rows();
+    LinReply::Error error = beginJournal(FlashJournal::Write, FlashJournal::imageHash(image), &rows);
+    if (error != LinReply::NoError)
+        return error;
+    QList<int32_t> addresses;
+    QList<QByteArray> frames;
+    for (int32_t address : rows)
+    {
+        addresses.append(address);
+        frames.append(writeFrame(address, image.rowData(address)));
+    }
+    error = transfer(flashWriteCommand, addresses, frames);
+    if (error == LinReply::NoError)
+        m_unconfirmedRows.clear();
+    else
+        m_unconfirmedRows = rows.mid(qMax(rows.indexOf(m_errorAddress), 0));
+    endJournal(error == LinReply::NoError);
+    updateSnapshot(image, plan, error == LinReply::NoError);
+    return error;
+}
+
+LinReply::Error FlashSession::writeVerified(FlashImage *image, const FlashWritePlan &plan, QVector<int32_t> *mismatches)
+{
+    LinReply::Error error = writeVerified(*image, plan, mismatches);
+    markWritten(image, *mismatches);
+    return error;
+}
+
+LinReply::Error FlashSession::writeVerified(const FlashImage &image, const FlashWritePlan &plan, QVector<int32_t> *mismatches)
+{
+    m_unconfirmedRows = plan.rows();
+    QVector<int32_t> rows = plan.rows();
+    LinReply::Error error = beginJournal(FlashJournal::Write, FlashJournal::imageHash(image), &rows);
+    if (error != LinReply::NoError)
+        return error;
+    if (rows.size() < plan.rows().size())
+    {
+        // JOURNAL KNOWS DEVICE ONLY BY ITS IDS, RESUMED ROWS ARE READ BACK INSTEAD OF TRUSTED
+        QVector<int32_t> resumed;
+        for (int32_t address : plan.rows())
+        {
+            if (!rows.contains(address))
+                resumed.append(address);
+        }
+        FlashImage readBack;
+        error = readRows(resumed, &readBack, false);
+        if (error != LinReply::NoError)
+        {
+            endJournal(false);
+            updateSnapshot(image, plan, false);
+            return error;
+        }
+        QVector<int32_t> different;
+        for (FlashImage::Row row : readBack)
+        {
+            if (!FlashImage::isSameRow(row.address, image.rowData(row.address), row.data))
+                different.append(row.address);
+        }
+        QVector<int32_t> planned;
+        for (int32_t address : plan.rows())
+        {
+            if (rows.contains(address) || different.contains(address))
+                planned.append(address);
+        }
+        rows = planned;
+    }
+    // DIFFERENT ROWS ARE REWRITTEN UP TO FLASH_VERIFY_RETRIES TIMES, ROWS NOT CONFIRMED
+    // BECAUSE OF LIN ERROR ARE SENT AGAIN IN NEW BATCH UP TO FLASH_ROW_RETRIES TIMES
+    int attempts = 0;
+    int failures = 0;
+    while (!rows.isEmpty())
+    {
+        QVector<int32_t> different;
+        QVector<int32_t> unconfirmed;
+        error = writeVerifyPass(image, rows, &different, &unconfirmed);
+        if (error != LinReply::NoError)
+        {
+            if (different.size() + unconfirmed.size() < rows.size())
+                failures = 0;
+            if ((error == LinReply::Aborted) || (++failures > FLASH_ROW_RETRIES))
+            {
+                m_unconfirmedRows = unconfirmed;
+                rows = different;
+                break;
+            }
+        }
+        else if (!different.isEmpty() && (++attempts > FLASH_VERIFY_RETRIES))
+        {
+            rows = different;
+            break;
+        }
+        rows.clear();
+        for (int32_t address : plan.rows())
+        {
+            if (different.contains(address) || unconfirmed.contains(address))
+                rows.append(address);
+        }
+    }
+    if (error == LinReply::NoError)
+        m_unconfirmedRows.clear();
+    *mismatches += rows;
+    endJournal((error == LinReply::NoError) && rows.isEmpty());
+    updateSnapshot(image, plan, (error == LinReply::NoError) && rows.isEmpty());
+    return error;
+}
+
+LinReply::Error FlashSession::verify(const FlashImage &image, QVector<int32_t> *mismatches)
+{
+    QVector<int32_t> rows;
+    for (FlashImage::Row row : image)
+        rows.append(row.address);
+    return verify(image, rows, mismatches);
+}
+
+LinReply::Error FlashSession::verify(const FlashImage &image, const QVector<int32_t> &rows, QVector<int32_t> *mismatches)
+{
+    FlashImage readBack;
+    LinReply::Error error = readRows(rows, &readBack);
+    for (FlashImage::Row row : readBack)
+    {
+        if (!FlashImage::isSameRow(row.address, image.rowData(row.address), row.data))
+            mismatches->append(row.address);
+    }
+    return error;
+}
+
+QString FlashSession::errorString(LinReply::Error error)
+{
+    switch (error)
+    {
+    case LinReply::NoError:
+        return QString();
+    case LinReply::EchoNotReceived:
+        return "Lin can't receive transmitted bytes";
+    case LinReply::ChecksumError:
+        return "Lin received frame with uncorrect checksum";
+    case LinReply::BadResponse:
+        return "Controller sent frame with uncorrect struct";
+    case LinReply::Aborted:
+        return "Aborted";
+    default:
+        return "No correct ack from controller, LIN works normally";
+    }
+}
+
+QByteArray FlashSession::readFrame(int32_t address)
+{
+    using namespace BootloaderLayout;
+    FrameBuffer<ReadRequest> frame;
+    frame.set<Sync>(LIN_SYNC_BYTE);
+    frame.set<Length>(ReadRequest::size - 2);
+    frame.set<Code>(FLASH_READ_CODE);
+    frame.set<Address>(static_cast<uint16_t>(address));
+    frame.placeChecksum();
+    return frame.toByteArray();
+}
+
+QByteArray FlashSession::writeFrame(int32_t address, const char *data)
+{
+    using namespace BootloaderLayout;
+    FrameBuffer<RowFrame> frame;
+    frame.set<Sync>(LIN_SYNC_BYTE);
+    frame.set<Length>(RowFrame::size - 2);
+    frame.set<Code>(FLASH_WRITE_CODE);
+    frame.set<Address>(static_cast<uint16_t>(address));
+    RowData::write(frame.bytes, data, FLASH_ROW_SIZE);
+    frame.placeChecksum();
+    return frame.toByteArray();
+}
+
+LinReply::Error FlashSession::readRows(const QVector<int32_t> &rows, FlashImage *image, bool journal)
+{
+    QList<int32_t> addresses;
+    QList<QByteArray> frames;
+    for (int32_t address : rows)
+    {
+        addresses.append(address);
+        frames.append(readFrame(address));
+    }
+    return transfer(flashReadCommand, addresses, frames, image, journal);
+}
+
+LinReply::Error FlashSession::writeVerifyPass(const FlashImage &image, const QVector<int32_t> &rows, QVector<int32_t> *mismatches,
+                                              QVector<int32_t> *unconfirmed)
+{
+    if (m_aborted.loadAcquire())
+    {
+        m_errorAddress = rows.first();
+        *unconfirmed += rows;
+        return LinReply::Aborted;
+    }
+    // READ OF ROW IS QUEUED RIGHT AFTER ITS WRITE, BUS NEVER WAITS FOR COMPARISON
+    int batch = m_link->newBatch();
+    QList<LinReply*> replies;
+    for (int32_t address : rows)
+    {
+        replies.append(m_link->submit(LinRequest(&flashWriteCommand, writeFrame(address, image.rowData(address)), batch)));
+        replies.append(m_link->submit(LinRequest(&flashReadCommand, readFrame(address), batch)));
+    }
+
+    LinReply::Error error = LinReply::NoError;
+    m_errorAddress = -1;
+    for (int i = 0; i < rows.size(); i++)
+    {
+        emit progress(i, rows.size());
+        LinReply *writeReply = replies.at(i * 2);
+        LinReply *readReply = replies.at(i * 2 + 1);
+        writeReply->waitForFinished();
+        readReply->waitForFinished();
+        error = (writeReply->error() != LinReply::NoError) ? writeReply->error() : readReply->error();
+        if (error != LinReply::NoError)
+        {
+            m_errorAddress = rows.at(i);
+            for (int j = i; j < rows.size(); j++)
+                unconfirmed->append(rows.at(j));
+            break;
+        }
+        // WHOLE ROW IS COMPARED AT ONCE, WORD BY WORD ONLY IF UNUSED BITS OR DEVICE ID DIFFER
+        const char *expected = image.rowData(rows.at(i));
+        const char *data = BootloaderLayout::RowData::read(readReply->frame().bytes);
+        if ((memcmp(expected, data, FLASH_ROW_SIZE) != 0) && !FlashImage::isSameRow(rows.at(i), expected, data))
+            mismatches->append(rows.at(i));
+        else if ((m_journal != 0) && m_journal->isActive())
+            m_journal->confirm(rows.at(i));
+    }
+    qDeleteAll(replies);
+    if (error == LinReply::NoError)
+        emit progress(rows.size(), rows.size());
+    return error;
+}
+
+void FlashSession::updateSnapshot(const FlashImage &image, const FlashWritePlan &plan, bool ok)
+{
+    // WRITTEN CONFIG ROW GIVES DEVICE NEW USER ID, DEVICE ID IS READ ONLY AND STAYS AS READ
+    QString key = m_deviceKey;
+    if (plan.rows().contains(FLASH_CONFIG_ADDRESS) && (m_deviceConfigRow.size() == FLASH_ROW_SIZE))
+    {
+        QByteArray configRow(image.rowData(FLASH_CONFIG_ADDRESS), FLASH_ROW_SIZE);
+        memcpy(configRow.data() + 6 * 2, m_deviceConfigRow.constData() + 6 * 2, 2);
+        key = DeviceSnapshotCache::deviceKey(configRow.constData());
+    }
+    if (m_cache != 0)
+    {
+        if (ok)
+        {
+            FlashImage written;
+            for (int32_t address : plan.rows())
+                written.setData(address, image.rowData(address), FLASH_ROW_SIZE, false);
+            m_cache->update(key, written, m_deviceKey);
+        }
+        else
+        {
+            m_cache->remove(m_deviceKey);
+            m_cache->remove(key);
+        }
+    }
+    m_deviceKey.clear();
+    m_deviceConfigRow.clear();
+}
+
+void FlashSession::markWritten(FlashImage *image, const QVector<int32_t> &mismatches)
+{
+    for (FlashImage::Row row : *image)
+        image->setRowDirty(row.address, false);
+    for (int32_t address : m_unconfirmedRows)
+        image->setRowDirty(address, true);
+    for (int32_t address : mismatches)
+        image->setRowDirty(address, true);
+}
+
+LinReply::Error FlashSession::beginJournal(FlashJournal::Operation operation, const QByteArray &hash, QVector<int32_t> *rows,
+                                           FlashImage *readImage)
+{
+    if ((m_journal == 0) || m_journal->fileName().isEmpty())
+        return LinReply::NoError;
+    // WRITE REUSES CONFIG ROW READ BY applySnapshot() JUST BEFORE IT
+    QByteArray configRow = m_deviceConfigRow;
+    if ((operation != FlashJournal::Write) || (configRow.size() != FLASH_ROW_SIZE))
+    {
+        QString key;
+        FlashImage deviceRows;
+        LinReply::Error error = readDeviceKey(&key, &deviceRows);
+        if (error != LinReply::NoError)
+            return error;
+        configRow = QByteArray(deviceRows.rowData(FLASH_CONFIG_ADDRESS), FLASH_ROW_SIZE);
+    }
+    QString device = FlashJournal::deviceIdentity(configRow.constData());
+    for (int32_t address : m_journal->begin(operation, hash, device, readImage))
+        rows->removeOne(address);
+    return LinReply::NoError;
+}
+
+void FlashSession::endJournal(bool ok)
+{
+    if (m_journal == 0)
+        return;
+    if (ok)
+        m_journal->finish();
+    else
+        m_journal->close();
+}
+
+LinReply::Error FlashSession::transfer(const LinCommand &command, const QList<int32_t> &addresses, const QList<QByteArray> &frames,
+                                       FlashImage *readImage, bool journal)
+{
+    LinReply::Error error = LinReply::NoError;
+    m_errorAddress = -1;
+    int start = 0;
+    int failures = 0;
+    while (start < frames.size())
+    {
+        if (m_aborted.loadAcquire())
+        {
+            error = LinReply::Aborted;
+            m_errorAddress = addresses.at(start);
+            break;
+        }
+        int batch = m_link->newBatch();
+        QList<LinReply*> replies;
+        for (int i = start; i < frames.size(); i++)
+            replies.append(m_link->submit(LinRequest(&command, frames.at(i), batch)));
+
+        int i = start;
+        for (; i < frames.size(); i++)
+        {
+            emit progress(i, frames.size());
+            LinReply *reply = replies.at(i - start);
+            reply->waitForFinished();
+            error = reply->error();
+            if (error != LinReply::NoError)
+                break;
+            failures = 0;
+            const char *data = 0;
+            if (readImage != 0)
+            {
+                data = BootloaderLayout::RowData::read(reply->frame().bytes);
+                readImage->setData(addresses.at(i), data, FLASH_ROW_SIZE, false);
+                emit rowRead(addresses.at(i), data);
+            }
+            if (journal && (m_journal != 0) && m_journal->isActive())
+                m_journal->confirm(addresses.at(i), data);
+        }
+        qDeleteAll(replies);
+        if (error == LinReply::NoError)
+            break;
+        m_errorAddress = addresses.at(i);
+        // TRANSACTION RETRIES OF ROW ARE SPENT, IT IS SENT AGAIN IN NEW BATCH
+        if ((error == LinReply::Aborted) || (++failures > FLASH_ROW_RETRIES))
+            break;
+        start = i;
+    }
+    if (error == LinReply::NoError)
+        emit progress(frames.size(), frames.size());
+    return error;
+}
@@ -0,0 +1,137 @@
+#ifndef FLASH_SESSION_H
+#define FLASH_SESSION_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QList>
+#include <QVector>
+
+#include "flash_image.h"
+#include "flash_write_plan.h"
+#include "device_snapshot_cache.h"
+#include "flash_journal.h"
+#include "lin_link.h"
+
+#define FLASH_SAMPLE_ROWS   2       // READ BACK BEFORE SNAPSHOT IS TRUSTED
+#define FLASH_VERIFY_RETRIES 2      // REWRITES OF ROW WHICH READS BACK DIFFERENT
+#define FLASH_ROW_RETRIES   3       // NEW BATCHES FROM FAILED ROW, AFTER TRANSACTION RETRIES
+
+// Bootloader transfers of whole rows. Calls block in local event loop until all rows are
+// done or first error, progress is reported by signals.
+class FlashSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FlashSession(LinLink *link, QObject *parent = 0);
+
+    // WITH CACHE READ AND WRITTEN ROWS ARE STORED TO SNAPSHOT OF DEVICE AND WRITES SKIP
+    // UNCHANGED ROWS, 0 DISABLES IT
+    void setSnapshotCache(DeviceSnapshotCache *cache, int sampleRows = FLASH_SAMPLE_ROWS);
+
+    // WITH JOURNAL READ AND WRITE CONTINUE FROM FIRST ROW NOT CONFIRMED BY FAILED ATTEMPT,
+    // 0 DISABLES IT
+    void setJournal(FlashJournal *journal) { m_journal = journal; }
+
+    // READS ROWS FROM START TO END WORD ADDRESS TO IMAGE, READ ROWS ARE CLEAN
+    LinReply::Error read(int32_t startAddress, int32_t endAddress, FlashImage *image);
+
+    // READS CONFIG ROW, KEY IS EMPTY IF DEVICE HAS NO USER ID
+    LinReply::Error readDeviceKey(QString *key, FlashImage *configRow = 0);
+
+    // READS DEVICE KEY AND SAMPLE ROWS, IF THEY MATCH SNAPSHOT UNCHANGED ROWS ARE EXCLUDED
+    // FROM PLAN, ELSE SNAPSHOT IS DROPPED. NEXT WRITE STORES ITS ROWS TO SNAPSHOT
+    LinReply::Error applySnapshot(const FlashImage &image, FlashWritePlan *plan);
+
+    // WRITES ROWS OF FlashWritePlan, DONE ROWS ARE MARKED CLEAN
+    LinReply::Error write(FlashImage *image);
+
+    LinReply::Error write(FlashImage *image, const FlashWritePlan &plan);
+
+    // SAME WITHOUT MARKING, IMAGE CAN BE SHARED BY SEVERAL SESSIONS
+    LinReply::Error write(const FlashImage &image);
+
+    LinReply::Error write(const FlashImage &image, const FlashWritePlan &plan);
+
+    // EVERY WRITE IS FOLLOWED BY READ BACK OF SAME ROW IN ONE REQUEST STREAM, DIFFERENT ROWS
+    // ARE WRITTEN AGAIN UP TO FLASH_VERIFY_RETRIES TIMES AND THEN ADDED TO MISMATCHES.
+    // ROWS CONFIRMED BY JOURNAL ARE READ BACK FIRST AND WRITTEN ONLY IF DIFFERENT
+    LinReply::Error writeVerified(FlashImage *image, const FlashWritePlan &plan, QVector<int32_t> *mismatches);
+
+    LinReply::Error writeVerified(const FlashImage &image, const FlashWritePlan &plan, QVector<int32_t> *mismatches);
+
+    // READS BACK PRESENT ROWS, ADDRESSES OF DIFFERENT ROWS ARE ADDED TO MISMATCHES
+    LinReply::Error verify(const FlashImage &image, QVector<int32_t> *mismatches);
+
+    // ONLY GIVEN ROWS, E.G. FlashWritePlan::rows()
+    LinReply::Error verify(const FlashImage &image, const QVector<int32_t> &rows, QVector<int32_t> *mismatches);
+
+    // CAN BE CALLED FROM ANY THREAD. ABORT IS STICKY: QUEUED REQUESTS ARE ABORTED AND NO NEW
+    // BATCH IS SUBMITTED, EVERY LATER CALL RETURNS LinReply::Aborted
+    void abort();
+
+    // ROW ADDRESS OF LAST FAILED REQUEST
+    int32_t errorAddress() const { return m_errorAddress; }
+
+    // PLANNED ROWS OF LAST WRITE NOT CONFIRMED BECAUSE OF ERROR, NOT COUNTED AS MISMATCHES
+    const QVector<int32_t> &unconfirmedRows() const { return m_unconfirmedRows; }
+
+    static QString errorString(LinReply::Error error);
+
+    static QByteArray readFrame(int32_t address);
+
+    static QByteArray writeFrame(int32_t address, const char *data);
+
+signals:
+
+    void progress(int done, int total);
+
+    void rowRead(int32_t address, const char *data);
+
+private:
+    LinLink *m_link;
+
+    int32_t m_errorAddress;
+
+    QVector<int32_t> m_unconfirmedRows;
+
+    DeviceSnapshotCache *m_cache;
+
+    int m_sampleRows;
+
+    // DEVICE OF LAST applySnapshot(), CLEARED BY WRITE
+    QString m_deviceKey;
+
+    // CONFIG ROW READ BY LAST applySnapshot(), CLEARED BY WRITE
+    QByteArray m_deviceConfigRow;
+
+    FlashJournal *m_journal;
+
+    QAtomicInt m_aborted;
+
+    // READS DEVICE IDENTITY AND REMOVES ROWS CONFIRMED BY PREVIOUS ATTEMPT
+    LinReply::Error beginJournal(FlashJournal::Operation operation, const QByteArray &hash, QVector<int32_t> *rows,
+                                 FlashImage *readImage = 0);
+
+    void endJournal(bool ok);
+
+    // READ ROWS ARE CONFIRMED TO ACTIVE JOURNAL ONLY IF journal IS SET
+    LinReply::Error readRows(const QVector<int32_t> &rows, FlashImage *image, bool journal = true);
+
+    // ONE PASS OF writeVerified(), ROWS FROM FAILED ONE ARE UNCONFIRMED
+    LinReply::Error writeVerifyPass(const FlashImage &image, const QVector<int32_t> &rows, QVector<int32_t> *mismatches,
+                                    QVector<int32_t> *unconfirmed);
+
+    // SNAPSHOT OF DEVICE FROM LAST applySnapshot() GETS WRITTEN ROWS OR IS DROPPED
+    void updateSnapshot(const FlashImage &image, const FlashWritePlan &plan, bool ok);
+
+    // SKIPPED AND CONFIRMED ROWS ARE CLEAN, UNCONFIRMED ROWS AND MISMATCHES STAY DIRTY
+    void markWritten(FlashImage *image, const QVector<int32_t> &mismatches = QVector<int32_t>());
+
+    // SUBMITS REQUESTS AS ONE BATCH AND WAITS THEM IN ORDER, FAILED ROW STARTS NEW BATCH
+    // UP TO FLASH_ROW_RETRIES TIMES
+    LinReply::Error transfer(const LinCommand &command, const QList<int32_t> &addresses, const QList<QByteArray> &frames,
+                             FlashImage *readImage = 0, bool journal = true);
+};
+
+#endif // FLASH_SESSION_H
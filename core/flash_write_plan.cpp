@@ -0,0 +1,69 @@
+#include "flash_write_plan.h"
+
+FlashWritePlan::FlashWritePlan(const FlashImage &image, bool skipErased) :
+    m_programRows(0),
+    m_skippedRows(0),
+    m_unchangedRows(0)
+{
+    QVector<int32_t> configRows;
+    m_rows.reserve(image.rowsCount());
+    for (FlashImage::Row row : image)
+    {
+        if (row.address >= FLASH_CONFIG_ADDRESS)
+            configRows.append(row.address);
+        else if (skipErased && isErasedRow(row.data))
+            m_skippedRows++;
+        else
+            m_rows.append(row.address);
+    }
+    m_programRows = m_rows.size();
+    m_rows += configRows;
+}
+
+int FlashWritePlan::estimatedTime(int baudRate) const
+{
+    if (baudRate <= 0)
+        return 0;
+    // 10 BITS PER BYTE, ECHO GOES TOGETHER WITH TRANSMISSION
+    qint64 bits = static_cast<qint64>(frames()) * (FLASH_WRITE_FRAME_SIZE + FLASH_WRITE_ACK_SIZE) * 10;
+    return static_cast<int>(bits * 1000 / baudRate) + frames() * FLASH_ROW_WRITE_TIME;
+}
+
+QString FlashWritePlan::summary(int baudRate) const
+{
+    QString text = QString("%1 rows to write (%2 program, %3 config), %4 erased skipped, ")
+            .arg(frames()).arg(programRows()).arg(configRows()).arg(skippedRows());
+    if (m_unchangedRows > 0)
+        text += QString("%1 unchanged, ").arg(m_unchangedRows);
+    return text + QString("%1 bytes, ~%2 ms at %3").arg(bytes()).arg(estimatedTime(baudRate)).arg(baudRate);
+}
+
+void FlashWritePlan::excludeUnchanged(const FlashImage &image, const FlashImage &snapshot)
+{
+    QVector<int32_t> rows;
+    rows.reserve(m_rows.size());
+    int programRows = m_programRows;
+    for (int i = 0; i < m_rows.size(); i++)
+    {
+        int32_t address = m_rows.at(i);
+        if (snapshot.isRowPresent(address) && FlashImage::isSameRow(address, image.rowData(address), snapshot.rowData(address)))
+        {
+            m_unchangedRows++;
+            if (i < programRows)
+                m_programRows--;
+        }
+        else
+            rows.append(address);
+    }
+    m_rows = rows;
+}
+
+bool FlashWritePlan::isErasedRow(const char *data)
+{
+    for (int i = 0; i < FLASH_ROW_SIZE; i += 2)
+    {
+        if ((static_cast<uint8_t>(data[i]) != 0xFF) || ((static_cast<uint8_t>(data[i + 1]) & 0x3F) != 0x3F))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef FLASH_WRITE_PLAN_H
+#define FLASH_WRITE_PLAN_H
+
+#include <QVector>
+#include <QString>
+
+#include "flash_image.h"
+
+#define FLASH_WRITE_FRAME_SIZE  (6 + FLASH_ROW_SIZE)
+#define FLASH_WRITE_ACK_SIZE    4
+#define FLASH_ROW_WRITE_TIME    3   // MS, BOOTLOADER SELF-PROGRAMMING OF ONE ROW
+
+// Rows of image which really have to be sent. Erased rows (all words 0x3FFF) are dropped,
+// config region rows go after program rows, so program is complete before configuration
+// words change. Skipped rows keep what device already has in them. Rows equal to snapshot
+// of device flash can be excluded too.
+class FlashWritePlan
+{
+public:
+    explicit FlashWritePlan(const FlashImage &image, bool skipErased = true);
+
+    // PROGRAM ROWS, THEN CONFIG ROWS, ASCENDING
+    const QVector<int32_t> &rows() const { return m_rows; }
+
+    int programRows() const { return m_programRows; }
+
+    int configRows() const { return m_rows.size() - m_programRows; }
+
+    int skippedRows() const { return m_skippedRows; }
+
+    int unchangedRows() const { return m_unchangedRows; }
+
+    int frames() const { return m_rows.size(); }
+
+    // BYTES SENT BY TOOL
+    int bytes() const { return m_rows.size() * FLASH_WRITE_FRAME_SIZE; }
+
+    // MS ON WIRE WITH ACKS AND ROW PROGRAMMING TIME
+    int estimatedTime(int baudRate) const;
+
+    QString summary(int baudRate) const;
+
+    // DROPS ROWS WHICH DEVICE ALREADY HAS ACCORDING TO SNAPSHOT, SEE DeviceSnapshotCache
+    void excludeUnchanged(const FlashImage &image, const FlashImage &snapshot);
+
+    static bool isErasedRow(const char *data);
+
+private:
+    QVector<int32_t> m_rows;
+
+    int m_programRows;
+
+    int m_skippedRows;
+
+    int m_unchangedRows;
+};
+
+#endif // FLASH_WRITE_PLAN_H
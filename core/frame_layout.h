@@ -0,0 +1,194 @@
+#ifndef FRAME_LAYOUT_H
+#define FRAME_LAYOUT_H
+
+#include <QtGlobal>
+#include <QByteArray>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lin_frame_decoder.h"
+#include "flash_image.h"
+
+// Compile-time descriptions of LIN frames and of the settings block. A field knows its
+// offset, type and valid range; a layout knows its size and where its checksum is and what it
+// covers. Fields outside their frame fail to compile. Frames are encoded in place in stack
+// buffers (FrameBuffer), so a whole frame costs one QByteArray when it is handed to LinLink.
+
+// LITTLE-ENDIAN INTEGER OF TYPE T AT offset
+template <typename T, int Offset, int Min = 0, int Max = -1>
+struct FrameField
+{
+    typedef T Type;
+
+    static constexpr int offset = Offset;
+
+    static constexpr int size = sizeof(T);
+
+    static void write(uint8_t *frame, T value)
+    {
+        for (int i = 0; i < int(sizeof(T)); i++)
+            frame[Offset + i] = static_cast<uint8_t>((static_cast<uint64_t>(value) >> (i * 8)) & 0xFF);
+    }
+
+    static T read(const uint8_t *frame)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < int(sizeof(T)); i++)
+            value |= static_cast<uint64_t>(frame[Offset + i]) << (i * 8);
+        return static_cast<T>(value);
+    }
+
+    // RANGE IS CHECKED ONLY IF GIVEN (MIN <= MAX)
+    static bool isValid(const uint8_t *frame)
+    {
+        int value = read(frame);
+        return (Min > Max) || ((value >= Min) && (value <= Max));
+    }
+};
+
+// COUNT BYTES STARTING AT offset
+template <int Offset, int Count>
+struct FrameBytes
+{
+    static constexpr int offset = Offset;
+
+    static constexpr int size = Count;
+
+    // SHORTER DATA IS PADDED BY ZEROS
+    static void write(uint8_t *frame, const char *data, int dataSize)
+    {
+        int copied = (dataSize < 0) ? 0 : ((dataSize > Count) ? Count : dataSize);
+        memcpy(frame + Offset, data, copied);
+        memset(frame + Offset + copied, 0, Count - copied);
+    }
+
+    static const char *read(const uint8_t *frame) { return reinterpret_cast<const char*>(frame + Offset); }
+};
+
+// Size bytes frame, checksum at ChecksumAt is sum of bytes [SumFrom, SumTo)
+template <int Size, int ChecksumAt, int SumFrom, int SumTo>
+struct FrameLayout
+{
+    static constexpr int size = Size;
+
+    static constexpr int checksumAt = ChecksumAt;
+
+    static uint8_t checksum(const uint8_t *frame)
+    {
+        uint8_t sum = 0;
+        for (int i = SumFrom; i < SumTo; i++)
+            sum += frame[i];
+        return sum;
+    }
+
+    static void placeChecksum(uint8_t *frame) { frame[ChecksumAt] = checksum(frame); }
+
+    static bool isChecksumCorrect(const uint8_t *frame) { return frame[ChecksumAt] == checksum(frame); }
+
+    Q_STATIC_ASSERT((ChecksumAt >= 0) && (ChecksumAt < Size));
+    Q_STATIC_ASSERT((SumFrom >= 0) && (SumFrom <= SumTo) && (SumTo <= Size));
+    Q_STATIC_ASSERT((ChecksumAt < SumFrom) || (ChecksumAt >= SumTo));
+};
+
+// FIELD IS INSIDE FRAME OF LAYOUT
+#define FRAME_FIELD_FITS(Layout, Field) \
+    Q_STATIC_ASSERT(((Field::offset) >= 0) && ((Field::offset) + (Field::size) <= (Layout::size)))
+
+// Block without checksum
+template <int Size>
+struct BlockLayout
+{
+    static constexpr int size = Size;
+};
+
+// Stack buffer of one frame
+template <typename Layout>
+struct FrameBuffer
+{
+    uint8_t bytes[Layout::size];
+
+    FrameBuffer() { memset(bytes, 0, sizeof(bytes)); }
+
+    explicit FrameBuffer(const char *data) { memcpy(bytes, data, sizeof(bytes)); }
+
+    template <typename Field>
+    void set(typename Field::Type value) { Field::write(bytes, value); }
+
+    template <typename Field>
+    typename Field::Type get() const { return Field::read(bytes); }
+
+    void placeChecksum() { Layout::placeChecksum(bytes); }
+
+    QByteArray toByteArray() const { return QByteArray(reinterpret_cast<const char*>(bytes), sizeof(bytes)); }
+};
+
+// CONTROLLER COMMAND (11 BYTES): SYNC, CODE, 8 DATA BYTES, SUM OF CODE AND DATA
+namespace CommandLayout
+{
+    typedef FrameLayout<COMMAND_FRAME_SIZE, COMMAND_FRAME_SIZE - 1, 1, COMMAND_FRAME_SIZE - 1> Frame;
+    typedef FrameField<uint8_t, 0> Sync;
+    typedef FrameField<uint8_t, 1> Code;
+    typedef FrameBytes<2, COMMAND_FRAME_SIZE - 3> Data;
+
+    FRAME_FIELD_FITS(Frame, Sync);
+    FRAME_FIELD_FITS(Frame, Code);
+    FRAME_FIELD_FITS(Frame, Data);
+}
+
+// 0x17 EXTERNAL POSITIONS COMMAND
+namespace ExtPositionsLayout
+{
+    typedef CommandLayout::Frame Frame;
+    typedef FrameField<int16_t, 2> Corrector1;
+    typedef FrameField<int16_t, 4> Corrector2;
+    typedef FrameField<uint8_t, 6, 0, 1> ExtControl;
+
+    FRAME_FIELD_FITS(Frame, Corrector1);
+    FRAME_FIELD_FITS(Frame, Corrector2);
+    FRAME_FIELD_FITS(Frame, ExtControl);
+}
+
+// CONTROLLER ACK (0x25): SYNC, CODE, ERROR CODE, CHECKSUM
+namespace AckLayout
+{
+    typedef FrameLayout<ACK_FRAME_SIZE, ACK_FRAME_SIZE - 1, 1, ACK_FRAME_SIZE - 1> Frame;
+    typedef FrameField<uint8_t, 2> ErrorCode;
+
+    FRAME_FIELD_FITS(Frame, ErrorCode);
+}
+
+// BOOTLOADER FRAMES: SYNC, LENGTH FROM CODE, SUM FROM CODE, CODE, WORD ADDRESS, ROW DATA
+namespace BootloaderLayout
+{
+    typedef FrameLayout<6, 2, 3, 6> ReadRequest;
+    typedef FrameLayout<6 + FLASH_ROW_SIZE, 2, 3, 6 + FLASH_ROW_SIZE> RowFrame;
+    typedef FrameField<uint8_t, 0> Sync;
+    typedef FrameField<uint8_t, 1> Length;
+    typedef FrameField<uint8_t, 3> Code;
+    typedef FrameField<uint16_t, 4> Address;
+    typedef FrameBytes<6, FLASH_ROW_SIZE> RowData;
+
+    FRAME_FIELD_FITS(ReadRequest, Address);
+    FRAME_FIELD_FITS(RowFrame, RowData);
+}
+
+// SETTINGS BLOCK (54 BYTES), RANGES ARE WHAT CONTROLLER ACCEPTS
+namespace SettingsLayout
+{
+    typedef BlockLayout<SETTINGS_DATA_SIZE - 3> Block;
+    typedef FrameField<uint8_t, 0, 0, 2> CorrectorsNum;
+    typedef FrameField<uint8_t, 1, 2, 16> PositionsNum;
+    typedef FrameField<uint8_t, 2, 1, 255> PositionMult;
+    typedef FrameBytes<3, 2> CorrectorAddresses;
+    typedef FrameBytes<5, 2> StartPositions;
+    typedef FrameBytes<7, 15> AdcValues;
+    typedef FrameBytes<22, 32> Positions;
+
+    FRAME_FIELD_FITS(Block, CorrectorsNum);
+    FRAME_FIELD_FITS(Block, PositionsNum);
+    FRAME_FIELD_FITS(Block, PositionMult);
+    FRAME_FIELD_FITS(Block, Positions);
+}
+
+#endif // FRAME_LAYOUT_H
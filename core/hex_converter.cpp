@@ -0,0 +1,231 @@
+#include "hex_converter.h"
+
+#include <string.h>
+
+namespace {
+
+// 255 DATA BYTES + LENGTH, ADDRESS (2), TYPE AND CHECKSUM
+const int HEX_MAX_RECORD_BYTES = 255 + 5;
+
+const uint8_t HEX_NOT_DIGIT = 0xFF;
+
+struct HexDigitTable
+{
+    uint8_t values[256];
+
+    HexDigitTable()
+    {
+        memset(values, HEX_NOT_DIGIT, sizeof(values));
+        for (int i = 0; i < 10; i++)
+            values['0' + i] = i;
+        for (int i = 0; i < 6; i++)
+        {
+            values['A' + i] = 10 + i;
+            values['a' + i] = 10 + i;
+        }
+    }
+};
+
+const HexDigitTable hexDigits;
+
+// RETURNS BYTES NUM IN STR OR -1 (NUMBER OF BAD SYMBOL IN badSymbol)
+int decodeHexLine(const char *line, int length, uint8_t *bytes, int *badSymbol)
+{
+    int bytesNum = (length - 1) / 2;
+    for (int j = 0; j < bytesNum; j++)
+    {
+        const char *pair = line + 1 + j * 2;
+        uint8_t high = hexDigits.values[(uint8_t)(pair[0])];
+        uint8_t low = hexDigits.values[(uint8_t)(pair[1])];
+        int value = high * 16 + low;
+        if ((high == HEX_NOT_DIGIT) || (low == HEX_NOT_DIGIT))
+        {
+            // RARE CASES (" F", "+F" ...) - SAME CONVERSION AS QString::toInt
+            bool conversionSuccess = false;
+            value = QByteArray::fromRawData(pair, 2).toInt(&conversionSuccess, 16);
+            if (!conversionSuccess)
+            {
+                *badSymbol = j;
+                return -1;
+            }
+        }
+        if (j < HEX_MAX_RECORD_BYTES)
+            bytes[j] = value;
+    }
+    return bytesNum;
+}
+
+// STR WITH NOT ASCII SYMBOLS - LENGTH AND SYMBOLS ARE COUNTED IN UTF-16 AS BEFORE
+int decodeHexString(const QString &line, uint8_t *bytes, int *badSymbol)
+{
+    int bytesNum = (line.length() - 1) / 2;
+    for (int j = 0; j < bytesNum; j++)
+    {
+        bool conversionSuccess = false;
+        int value = line.mid(1 + j * 2, 2).toInt(&conversionSuccess, 16);
+        if (!conversionSuccess)
+        {
+            *badSymbol = j;
+            return -1;
+        }
+        if (j < HEX_MAX_RECORD_BYTES)
+            bytes[j] = value;
+    }
+    return bytesNum;
+}
+
+}
+
+QString parseHexData(const char *data, qint64 size, const HexRecordHandler &handler)
+{
+    if ((data == 0) || (size <= 0))
+        return QString("Error: end of writing (type 1) not found");
+
+    // FILE TEXT ENDS ON FIRST ZERO BYTE, AS IN QString(QByteArray)
+    const char *end = static_cast<const char*>(memchr(data, 0, size));
+    if (end == 0)
+        end = data + size;
+
+    bool isSegmentAddressChoosen = false;
+    int32_t segmentAddress = 0;
+    int32_t lineAddress = 0;
+    uint8_t bytes[HEX_MAX_RECORD_BYTES];
+    const char *nextLine = data;
+    for (int i = 0; nextLine != 0; i++)
+    {
+        const char *line = nextLine;
+        const char *lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (lineEnd != 0)
+            nextLine = lineEnd + 1;
+        else
+        {
+            lineEnd = end;
+            nextLine = 0;
+        }
+        int lineLength = lineEnd - line;
+        if (lineLength == 0)
+            continue;
+        if (line[0] != ':')
+            continue;
+
+        bool isAscii = true;
+        for (int j = 0; j < lineLength; j++)
+            if (((uint8_t)(line[j])) & 0x80)
+            {
+                isAscii = false;
+                break;
+            }
+        QString wideLine;
+        if (!isAscii)
+        {
+            wideLine = QString::fromUtf8(line, lineLength);
+            lineLength = wideLine.length();
+        }
+
+        if ((lineLength % 2) != 1)
+            return QString("Error: symbols num in str %1 not correct").arg(i);
+        int badSymbol = 0;
+        int bytesNum = isAscii ? decodeHexLine(line, lineLength, bytes, &badSymbol) : decodeHexString(wideLine, bytes, &badSymbol);
+        if (bytesNum < 0)
+            return QString("Error: symbol %1  in str %2 not correct").arg(badSymbol).arg(i);
+        if (bytesNum < 5)
+            return QString("Error: str %1 is too short (%2 bytes, minimum - 5)").arg(i).arg(bytesNum);
+        uint8_t dataLength = bytes[0];
+        if ((dataLength + 5) != bytesNum)
+            return QString("Error: str %1 has not correct length").arg(i);
+        uint8_t checksum = 0;
+        for (int j = 0; j < bytesNum; j++)
+            checksum += bytes[j];
+        // ADDRESS RECORD WITHOUT DATA - SECOND ADDRESS BYTE READ AS ZERO
+        uint8_t addressByte = (bytesNum > 5) ? bytes[5] : 0;
+
+        int32_t currentAddress = ((uint16_t)(bytes[1])) * 256 + ((uint16_t)(bytes[2]));
+        switch (bytes[3])
+        {
+            case 0:
+            {
+                HexRecord record;
+                record.line = i;
+                record.address = currentAddress + (isSegmentAddressChoosen ? segmentAddress : lineAddress);
+                record.data = bytes + 4;
+                record.length = dataLength;
+                record.checksumCorrect = (checksum == 0);
+                QString error = handler(record);
+                if (!error.isEmpty())
+                    return error;
+                break;
+            }
+            case 1:
+                return QString();
+            case 2:
+                segmentAddress = ((int32_t)(bytes[4])) * 16*256 + ((int32_t)addressByte) * 16;
+                isSegmentAddressChoosen = true;
+                break;
+            case 4:
+                lineAddress = (int32_t)(((uint32_t)(bytes[4])) * 256*256*256 + ((uint32_t)addressByte) * 256*256);
+                isSegmentAddressChoosen = false;
+                break;
+            default:
+                return QString("Error: str %1 has not correct type").arg(i);
+        }
+    }
+    return QString("Error: end of writing (type 1) not found");
+}
+
+QString hexFileToImage(const char *hexData, qint64 size, FlashImage *image)
+{
+    image->clear();
+    QString error = parseHexData(hexData, size, [image](const HexRecord &record) {
+        // ADDRESS DIV 2 BECAUSE ONE PIC WORD HAS 2 BYTES
+        if (!image->setData(record.address / 2, reinterpret_cast<const char*>(record.data), record.length))
+            return QString("Error: str %1 has address out of device memory (%2)").arg(record.line).arg(record.address / 2, 0, 16);
+        return QString();
+    });
+    if (!error.isEmpty())
+        image->clear();
+    return error;
+}
+
+static void appendHexRecord(QByteArray *hex, uint8_t type, uint16_t address, const char *data, int length)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    uint8_t bytes[4 + 16];
+    bytes[0] = length;
+    bytes[1] = address >> 8;
+    bytes[2] = address & 0xFF;
+    bytes[3] = type;
+    if (length > 0)
+        memcpy(bytes + 4, data, length);
+    uint8_t checksum = 0;
+    hex->append(':');
+    for (int i = 0; i < length + 4; i++)
+    {
+        checksum += bytes[i];
+        hex->append(digits[bytes[i] >> 4]);
+        hex->append(digits[bytes[i] & 0x0F]);
+    }
+    checksum = -checksum;
+    hex->append(digits[checksum >> 4]);
+    hex->append(digits[checksum & 0x0F]);
+    hex->append('\n');
+}
+
+QByteArray imageToHexFile(const FlashImage &image)
+{
+    QByteArray hex;
+    int32_t lineAddress = 0;
+    for (FlashImage::Row row : image)
+    {
+        int32_t byteAddress = row.address * 2;
+        if ((byteAddress & 0xFFFF0000) != lineAddress)
+        {
+            lineAddress = byteAddress & 0xFFFF0000;
+            char upperAddress[2] = {static_cast<char>(lineAddress >> 24), static_cast<char>(lineAddress >> 16)};
+            appendHexRecord(&hex, 4, 0, upperAddress, 2);
+        }
+        for (int offset = 0; offset < FLASH_ROW_SIZE; offset += 16)
+            appendHexRecord(&hex, 0, (byteAddress + offset) & 0xFFFF, row.data + offset, 16);
+    }
+    appendHexRecord(&hex, 1, 0, 0, 0);
+    return hex;
+}
@@ -0,0 +1,29 @@
+#ifndef HEX_CONVERTER_H
+#define HEX_CONVERTER_H
+
+#include <QString>
+
+#include "flash_image.h"
+
+#include <functional>
+
+struct HexRecord
+{
+    int line;
+    int32_t address;        // BYTE ADDRESS WITH SEGMENT/LINEAR OFFSET ALREADY ADDED
+    const uint8_t *data;    // VALID ONLY INSIDE HANDLER CALL
+    uint8_t length;
+    bool checksumCorrect;
+};
+
+// RETURNS ERROR TEXT TO STOP PARSING, EMPTY STRING TO CONTINUE
+typedef std::function<QString(const HexRecord &record)> HexRecordHandler;
+
+QString parseHexData(const char *data, qint64 size, const HexRecordHandler &handler);
+
+QString hexFileToImage(const char *data, qint64 size, FlashImage *image);
+
+// PRESENT ROWS AS INTEL HEX, 16 DATA BYTES PER RECORD
+QByteArray imageToHexFile(const FlashImage &image);
+
+#endif // HEX_CONVERTER_H
@@ -0,0 +1,162 @@
+#include "lin_frame_decoder.h"
+
+#include <string.h>
+
+bool LinFrame::isSame(const char *frame, int frameSize) const
+{
+    return (size == frameSize) && (memcmp(bytes, frame, size) == 0);
+}
+
+int LinRingBuffer::write(const char *data, int size)
+{
+    int written = qMin(size, freeSpace());
+    for (int i = 0; i < written; i++)
+        m_data[(m_head + m_size + i) % LIN_RING_BUFFER_SIZE] = data[i];
+    m_size += written;
+    return written;
+}
+
+void LinRingBuffer::consume(int size)
+{
+    size = qMin(size, m_size);
+    m_head = (m_head + size) % LIN_RING_BUFFER_SIZE;
+    m_size -= size;
+}
+
+LinFrameDecoder::LinFrameDecoder(QObject *parent) :
+    QObject(parent),
+    m_protocol(ControllerProtocol)
+{
+    resetStats();
+}
+
+void LinFrameDecoder::setProtocol(Protocol protocol)
+{
+    if (protocol == m_protocol)
+        return;
+    m_protocol = protocol;
+    reset();
+}
+
+void LinFrameDecoder::reset()
+{
+    m_stats.discardedBytes += m_buffer.size();
+    m_buffer.clear();
+}
+
+void LinFrameDecoder::resetStats()
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void LinFrameDecoder::push(const char *data, int size)
+{
+    m_stats.receivedBytes += size;
+    while (size > 0)
+    {
+        int written = m_buffer.write(data, size);
+        data += written;
+        size -= written;
+        if (written == 0)
+        {
+            // HARD CAP - OLDEST BYTE IS DROPPED (FRAMES ARE SHORTER THAN BUFFER, SO IT SHOULD NOT HAPPEN)
+            m_buffer.consume(1);
+            m_stats.discardedBytes++;
+        }
+        process();
+    }
+}
+
+int LinFrameDecoder::controllerFrameSize(uint8_t code)
+{
+    switch (code)
+    {
+        case VALUES_FRAME_CODE:
+            return CURRENT_DATA_SIZE;
+        case SETTINGS_FRAME_CODE:
+            return SETTINGS_DATA_SIZE;
+        case ACK_FRAME_CODE:
+            return ACK_FRAME_SIZE;
+        default:
+            break;
+    }
+    // OWN COMMANDS RECEIVED AS LIN ECHO: SETTINGS PARTS 0 - 6, EEPROM, READ SETTINGS, EXT VALUES, CLEAR ERRORS
+    if ((code <= 6) || ((code >= 0x10) && (code <= 0x12)) || (code == 0x17) || (code == 0x18))
+        return COMMAND_FRAME_SIZE;
+    return 0;
+}
+
+void LinFrameDecoder::process()
+{
+    while (m_buffer.size() > 0)
+    {
+        if (m_buffer.at(0) != LIN_SYNC_BYTE)
+        {
+            m_buffer.consume(1);
+            m_stats.discardedBytes++;
+            continue;
+        }
+        if (m_buffer.size() < 2)
+            return;
+        int size = frameSize(m_buffer.at(1));
+        if ((size == 0) || (size > LIN_FRAME_MAX_SIZE))
+        {
+            // NOT A FRAME HEADER
+            resync();
+            continue;
+        }
+        if (m_buffer.size() < size)
+            return;
+
+        bool checksumCorrect = isChecksumCorrect(size);
+        LinFrame frame;
+        frame.protocol = m_protocol;
+        frame.size = size;
+        for (int i = 0; i < size; i++)
+            frame.bytes[i] = m_buffer.at(i);
+        frame.code = (m_protocol == BootloaderProtocol) ? frame.bytes[3] : frame.bytes[1];
+
+        // FRAME IS CONSUMED BEFORE EMIT - SUBSCRIBERS CAN RESET DECODER
+        if (checksumCorrect)
+        {
+            m_buffer.consume(size);
+            m_stats.frames++;
+            emit frameReceived(frame);
+        }
+        else
+        {
+            // SYNC BYTE CAN BE PART OF DATA - NEXT FRAME IS SEARCHED INSIDE THIS ONE
+            m_stats.checksumErrors++;
+            resync();
+            emit checksumError(frame);
+        }
+    }
+}
+
+int LinFrameDecoder::frameSize(uint8_t header) const
+{
+    if (m_protocol == BootloaderProtocol)
+        return (header < 2) ? 0 : (header + 2);
+    return controllerFrameSize(header);
+}
+
+bool LinFrameDecoder::isChecksumCorrect(int size) const
+{
+    uint8_t sum = 0;
+    if (m_protocol == BootloaderProtocol)
+    {
+        for (int i = 3; i < size; i++)
+            sum += m_buffer.at(i);
+        return sum == m_buffer.at(2);
+    }
+    for (int i = 1; i < (size - 1); i++)
+        sum += m_buffer.at(i);
+    return sum == m_buffer.at(size - 1);
+}
+
+void LinFrameDecoder::resync()
+{
+    m_buffer.consume(1);
+    m_stats.discardedBytes++;
+    m_stats.resyncs++;
+}
@@ -0,0 +1,132 @@
+#ifndef LIN_FRAME_DECODER_H
+#define LIN_FRAME_DECODER_H
+
+#include <QObject>
+#include <QMetaType>
+
+#define LIN_SYNC_BYTE       0xE2
+
+#define CURRENT_DATA_SIZE   (16 + 3)
+#define SETTINGS_DATA_SIZE  (54 + 3)
+#define ACK_FRAME_SIZE      (1 + 3)
+#define COMMAND_FRAME_SIZE  11
+
+#define ACK_FRAME_CODE      0x25
+#define VALUES_FRAME_CODE   0x35
+#define SETTINGS_FRAME_CODE 0x15
+
+#define FLASH_READ_CODE         0x10
+#define FLASH_READ_ANSWER_CODE  0x12
+#define FLASH_WRITE_CODE        0x20
+#define FLASH_WRITE_ANSWER_CODE 0x22
+
+#define LIN_FRAME_MAX_SIZE      64
+#define LIN_RING_BUFFER_SIZE    1024
+
+// Frame as it was on the wire, with sync byte.
+// BOOTLOADER: SYNC, LENGTH (N), CHECKSUM, CODE, DATA (N - 2 BYTES)
+// CONTROLLER: SYNC, CODE, DATA, CHECKSUM (SIZE DEPENDS ON CODE)
+struct LinFrame
+{
+    uint8_t protocol;   // LinFrameDecoder::Protocol USED TO DECODE FRAME
+    uint8_t code;
+    int size;
+    uint8_t bytes[LIN_FRAME_MAX_SIZE];
+
+    const char *data() const { return reinterpret_cast<const char*>(bytes); }
+
+    bool isSame(const char *frame, int frameSize) const;
+};
+
+Q_DECLARE_METATYPE(LinFrame)
+
+struct LinDecoderStats
+{
+    quint64 receivedBytes;
+    quint64 frames;
+    quint64 checksumErrors;
+    quint64 discardedBytes;
+    quint64 resyncs;
+};
+
+Q_DECLARE_METATYPE(LinDecoderStats)
+
+class LinRingBuffer
+{
+public:
+    LinRingBuffer() : m_head(0), m_size(0) {}
+
+    int size() const { return m_size; }
+
+    int freeSpace() const { return LIN_RING_BUFFER_SIZE - m_size; }
+
+    // RETURNS NUMBER OF WRITTEN BYTES, REST NOT FIT TO BUFFER
+    int write(const char *data, int size);
+
+    uint8_t at(int offset) const { return m_data[(m_head + offset) % LIN_RING_BUFFER_SIZE]; }
+
+    void consume(int size);
+
+    void clear() { m_head = 0; m_size = 0; }
+
+private:
+    uint8_t m_data[LIN_RING_BUFFER_SIZE];
+
+    int m_head;
+
+    int m_size;
+};
+
+// Stateful decoder of received LIN bytes. Bytes are pushed as they come from port and stay
+// in bounded ring buffer only until frame at consume cursor is complete; frames are checked
+// in place and emitted once, without rescanning earlier data.
+class LinFrameDecoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Protocol
+    {
+        BootloaderProtocol,
+        ControllerProtocol
+    };
+
+    explicit LinFrameDecoder(QObject *parent = 0);
+
+    Protocol protocol() const { return m_protocol; }
+
+    void setProtocol(Protocol protocol);
+
+    void reset();
+
+    void push(const char *data, int size);
+
+    const LinDecoderStats &stats() const { return m_stats; }
+
+    void resetStats();
+
+    static int controllerFrameSize(uint8_t code);
+
+signals:
+
+    void frameReceived(const LinFrame &frame);
+
+    void checksumError(const LinFrame &frame);
+
+private:
+    Protocol m_protocol;
+
+    LinRingBuffer m_buffer;
+
+    LinDecoderStats m_stats;
+
+    void process();
+
+    int frameSize(uint8_t header) const;
+
+    bool isChecksumCorrect(int size) const;
+
+    void resync();
+};
+
+#endif // LIN_FRAME_DECODER_H
@@ -0,0 +1,87 @@
+#include "lin_link.h"
+
+LinLink::LinLink(const SerialWorker::RawDataHandler &rawDataHandler, QObject *parent) :
+    QObject(parent),
+    m_isOpen(false),
+    m_lastRequestId(0),
+    m_lastBatch(0)
+{
+    qRegisterMetaType<LinFrame>("LinFrame");
+    qRegisterMetaType<LinDecoderStats>("LinDecoderStats");
+    qRegisterMetaType<LinRequest>("LinRequest");
+    qRegisterMetaType<LinRttStats>("LinRttStats");
+
+    m_worker = new SerialWorker(rawDataHandler);
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &SerialWorker::frameReceived, this, &LinLink::frameReceived);
+    connect(m_worker, &SerialWorker::checksumError, this, &LinLink::checksumError);
+    connect(m_worker->engine(), &LinTransactionEngine::requestSent, this, &LinLink::requestSent);
+    connect(m_worker->engine(), &LinTransactionEngine::requestFinished, this, &LinLink::requestFinished);
+    connect(m_worker->engine(), &LinTransactionEngine::rttUpdated, this, &LinLink::storeRttStats);
+    m_thread.setObjectName("LIN I/O");
+    m_thread.start(QThread::HighPriority);
+}
+
+LinLink::~LinLink()
+{
+    if (m_isOpen)
+        close();
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool LinLink::open(const QString &portName, int baudRate)
+{
+    bool result = false;
+    m_rttStats.clear();
+    QMetaObject::invokeMethod(m_worker->engine(), "resetEstimates", Qt::QueuedConnection);
+    QMetaObject::invokeMethod(m_worker, "open", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, result),
+                              Q_ARG(QString, portName), Q_ARG(int, baudRate));
+    m_portName = portName;
+    m_isOpen = result;
+    return result;
+}
+
+LinDecoderStats LinLink::close()
+{
+    LinDecoderStats stats = LinDecoderStats();
+    abortAll();
+    QMetaObject::invokeMethod(m_worker, "close", Qt::BlockingQueuedConnection, Q_RETURN_ARG(LinDecoderStats, stats));
+    m_isOpen = false;
+    return stats;
+}
+
+LinReply *LinLink::submit(const LinRequest &request)
+{
+    LinReply *reply = new LinReply(request);
+    quint64 id = ++m_lastRequestId;
+    m_replies.insert(id, reply);
+    QMetaObject::invokeMethod(m_worker->engine(), "submit", Qt::QueuedConnection, Q_ARG(quint64, id), Q_ARG(LinRequest, request));
+    return reply;
+}
+
+void LinLink::abortAll()
+{
+    QMetaObject::invokeMethod(m_worker->engine(), "abortAll", Qt::QueuedConnection);
+}
+
+void LinLink::requestSent(quint64 id)
+{
+    LinReply *reply = m_replies.value(id);
+    if (reply != 0)
+        reply->markSent();
+}
+
+void LinLink::requestFinished(quint64 id, int error, const LinFrame &frame, int elapsed, int attempts)
+{
+    LinReply *reply = m_replies.take(id);
+    if (reply != 0)
+        reply->complete(error, frame, elapsed, attempts);
+}
+
+void LinLink::storeRttStats(const LinRttStats &stats)
+{
+    m_rttStats.insert(stats.name, stats);
+    emit rttUpdated(stats);
+}
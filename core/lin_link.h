@@ -0,0 +1,75 @@
+#ifndef LIN_LINK_H
+#define LIN_LINK_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QPointer>
+#include <QMap>
+
+#include "serial_worker.h"
+
+// Serial port with frame decoder running in own I/O thread, so bus timing does not
+// depend on GUI. Frames are delivered to owner thread already decoded.
+class LinLink : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LinLink(const SerialWorker::RawDataHandler &rawDataHandler = SerialWorker::RawDataHandler(), QObject *parent = 0);
+    ~LinLink();
+
+    bool open(const QString &portName, int baudRate);
+
+    LinDecoderStats close();
+
+    bool isOpen() const { return m_isOpen; }
+
+    QString portName() const { return m_portName; }
+
+    // QUEUES REQUEST TO TRANSACTION ENGINE, CALLER OWNS RETURNED REPLY
+    LinReply *submit(const LinRequest &request);
+
+    // ID FOR REQUESTS WHICH MUST BE ABORTED TOGETHER AFTER FIRST FAILURE
+    int newBatch() { return ++m_lastBatch; }
+
+    void abortAll();
+
+    // LAST LEARNED TIMING OF EACH COMMAND TYPE, BY NAME
+    QMap<QString, LinRttStats> rttStats() const { return m_rttStats; }
+
+signals:
+
+    void frameReceived(const LinFrame &frame);
+
+    void checksumError(const LinFrame &frame);
+
+    void rttUpdated(const LinRttStats &stats);
+
+private slots:
+
+    void requestSent(quint64 id);
+
+    void requestFinished(quint64 id, int error, const LinFrame &frame, int elapsed, int attempts);
+
+    void storeRttStats(const LinRttStats &stats);
+
+private:
+    QThread m_thread;
+
+    SerialWorker *m_worker;
+
+    bool m_isOpen;
+
+    QString m_portName;
+
+    quint64 m_lastRequestId;
+
+    int m_lastBatch;
+
+    QHash<quint64, QPointer<LinReply> > m_replies;
+
+    QMap<QString, LinRttStats> m_rttStats;
+};
+
+#endif // LIN_LINK_H
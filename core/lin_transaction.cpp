@@ -0,0 +1,339 @@
+#include "lin_transaction.h"
+#include "serial_worker.h"
+
+#include <QEventLoop>
+
+const LinCommand flashReadCommand     = {"flash read",      LinFrameDecoder::BootloaderProtocol, FLASH_READ_ANSWER_CODE,  6 + 32,             1000, 2, false};
+const LinCommand flashWriteCommand    = {"flash write",     LinFrameDecoder::BootloaderProtocol, FLASH_WRITE_ANSWER_CODE, 4,                  1000, 2, false};
+const LinCommand readSettingsCommand  = {"read settings",   LinFrameDecoder::ControllerProtocol, SETTINGS_FRAME_CODE,     SETTINGS_DATA_SIZE, 4000, 1, true};
+const LinCommand writeSettingsCommand = {"write settings",  LinFrameDecoder::ControllerProtocol, ACK_FRAME_CODE,          ACK_FRAME_SIZE,     4000, 1, true};
+// NEXT CHUNKS GO RIGHT AFTER FIRST ONE IN SAME CONTROLLER CYCLE, LOST ONES ARE RESENT BY CALLER
+const LinCommand writeSettingsChunkCommand = {"settings chunk", LinFrameDecoder::ControllerProtocol, ACK_FRAME_CODE,     ACK_FRAME_SIZE,     500,  0, false};
+const LinCommand eepromWriteCommand   = {"eeprom write",    LinFrameDecoder::ControllerProtocol, ACK_FRAME_CODE,          ACK_FRAME_SIZE,     4000, 1, true};
+const LinCommand eepromReadCommand    = {"eeprom read",     LinFrameDecoder::ControllerProtocol, ACK_FRAME_CODE,          ACK_FRAME_SIZE,     4000, 1, true};
+const LinCommand extPositionsCommand  = {"ext positions",   LinFrameDecoder::ControllerProtocol, ACK_FRAME_CODE,          ACK_FRAME_SIZE,     4000, 1, true};
+const LinCommand clearErrorsCommand   = {"clear errors",    LinFrameDecoder::ControllerProtocol, ACK_FRAME_CODE,          ACK_FRAME_SIZE,     4000, 1, true};
+
+LinReply::LinReply(const LinRequest &request, QObject *parent) :
+    QObject(parent),
+    m_request(request),
+    m_finished(false),
+    m_error(NoError),
+    m_frame(),
+    m_elapsed(0),
+    m_attempts(0)
+{
+}
+
+void LinReply::waitForFinished()
+{
+    if (m_finished)
+        return;
+    QEventLoop waitLoop;
+    connect(this, &LinReply::finished, &waitLoop, &QEventLoop::quit);
+    waitLoop.exec();
+}
+
+void LinReply::markSent()
+{
+    emit sent();
+}
+
+void LinReply::complete(int error, const LinFrame &frame, int elapsed, int attempts)
+{
+    m_error = static_cast<Error>(error);
+    m_frame = frame;
+    m_elapsed = elapsed;
+    m_attempts = attempts;
+    m_finished = true;
+    emit finished();
+}
+
+LinTransactionEngine::LinTransactionEngine(SerialWorker *worker) :
+    QObject(worker),
+    m_worker(worker),
+    m_state(Idle),
+    m_timer(this),
+    m_valuesPeriod(LIN_VALUES_FRAME_TIMEOUT),
+    m_longPeriods(0),
+    m_listenWindow(LIN_LISTEN_WINDOW),
+    m_predictionHits(0)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &LinTransactionEngine::timeout);
+}
+
+void LinTransactionEngine::submit(quint64 id, const LinRequest &request)
+{
+    Pending pending;
+    pending.id = id;
+    pending.request = request;
+    pending.attempt = 0;
+    pending.predicted = false;
+    pending.handshake = false;
+    m_queue.enqueue(pending);
+    if (m_state == Idle)
+        startNext();
+}
+
+void LinTransactionEngine::abortAll()
+{
+    if (m_state != Idle)
+    {
+        m_timer.stop();
+        m_state = Idle;
+        emit requestFinished(m_current.id, LinReply::Aborted, LinFrame(), 0, m_current.attempt);
+    }
+    while (!m_queue.isEmpty())
+        emit requestFinished(m_queue.dequeue().id, LinReply::Aborted, LinFrame(), 0, 0);
+    m_worker->setProtocol(LinFrameDecoder::ControllerProtocol);
+}
+
+void LinTransactionEngine::resetEstimates()
+{
+    m_rtt.clear();
+    m_valuesPeriod.reset();
+    m_lastValuesFrame.invalidate();
+    m_longPeriods = 0;
+    m_listenWindow = LIN_LISTEN_WINDOW;
+    m_predictionHits = 0;
+}
+
+void LinTransactionEngine::frameReceived(const LinFrame &frame)
+{
+    if ((frame.protocol == LinFrameDecoder::ControllerProtocol) && (frame.code == VALUES_FRAME_CODE))
+    {
+        int period = m_lastValuesFrame.isValid() ? static_cast<int>(m_lastValuesFrame.restart()) : -1;
+        if (!m_lastValuesFrame.isValid())
+            m_lastValuesFrame.start();
+        // GAP AFTER BOOTLOADER SESSION OR LOST FRAME IS NOT A PERIOD
+        bool lostFrame = isPredictable() && (period > m_valuesPeriod.srtt() * 3 / 2);
+        if (!lostFrame)
+            m_longPeriods = 0;
+        else if (++m_longPeriods >= LIN_PERIOD_CHANGE_SAMPLES)
+        {
+            // NOT LOST FRAMES BUT SLOWER CONTROLLER
+            m_valuesPeriod.reset();
+            m_longPeriods = 0;
+            lostFrame = false;
+        }
+        if ((period >= 0) && (period <= m_valuesPeriod.maxTimeout()) && !lostFrame)
+        {
+            m_valuesPeriod.addSample(period);
+            emitStats("values frame", m_valuesPeriod);
+        }
+    }
+    if (m_state == Idle)
+        return;
+    const LinCommand *command = m_current.request.command;
+
+    if (m_state == WaitValuesFrame)
+    {
+        if ((frame.protocol == LinFrameDecoder::ControllerProtocol) && (frame.code == VALUES_FRAME_CODE))
+            send();
+        return;
+    }
+
+    if (m_state == WaitEcho)
+    {
+        if (frame.isSame(m_current.request.frame.constData(), m_current.request.frame.size()))
+            m_state = WaitResponse;
+        return;
+    }
+
+    if ((command->protocol == LinFrameDecoder::ControllerProtocol) && (frame.code != command->responseCode))
+        return;
+    if ((frame.code != command->responseCode) || (frame.size != command->responseSize))
+        finish(LinReply::BadResponse, frame);
+    else
+        finish(LinReply::NoError, frame);
+}
+
+void LinTransactionEngine::checksumError(const LinFrame &frame)
+{
+    if (m_state != WaitResponse)
+        return;
+    const LinCommand *command = m_current.request.command;
+    if ((command->protocol == LinFrameDecoder::ControllerProtocol) && (frame.code != command->responseCode))
+        return;
+    finish(LinReply::ChecksumError, frame);
+}
+
+void LinTransactionEngine::timeout()
+{
+    switch (m_state)
+    {
+    case WaitValuesFrame:
+        // VALUES FRAME WAS LOST OR CORRUPTED, CONTROLLER LISTENS ANYWAY
+        if (!m_current.handshake && isPredictable())
+        {
+            m_current.predicted = true;
+            send();
+            break;
+        }
+        m_valuesPeriod.backoff();
+        finish(LinReply::NoValuesFrame);
+        break;
+    case WaitEcho:
+        if (!m_current.predicted)
+            estimator(m_current.request.command).backoff();
+        finish(LinReply::EchoNotReceived);
+        break;
+    case WaitResponse:
+        // CONTROLLER WHICH DID NOT LISTEN SAYS NOTHING ABOUT ROUND TRIP
+        if (!m_current.predicted)
+            estimator(m_current.request.command).backoff();
+        finish(LinReply::NoResponse);
+        break;
+    default:
+        break;
+    }
+}
+
+bool LinTransactionEngine::isPredictable() const
+{
+    return (m_valuesPeriod.samples() >= LIN_PERIOD_MIN_SAMPLES) && m_lastValuesFrame.isValid();
+}
+
+bool LinTransactionEngine::isInListenWindow() const
+{
+    return isPredictable() && (m_lastValuesFrame.elapsed() < m_listenWindow);
+}
+
+int LinTransactionEngine::predictedSendDelay() const
+{
+    int period = qMax(1, qRound(m_valuesPeriod.srtt()));
+    int phase = static_cast<int>(m_lastValuesFrame.elapsed() % period);
+    // MIDDLE OF LISTEN WINDOW, SO JITTER OF FRAME DOES NOT PUT REQUEST BEFORE IT
+    return period - phase + m_listenWindow / 2;
+}
+
+void LinTransactionEngine::predictionDone(bool hit)
+{
+    int maxWindow = qMax(1, qRound(m_valuesPeriod.srtt() / 2));
+    if (hit)
+    {
+        m_predictionHits++;
+        m_listenWindow = qMin(m_listenWindow + 1, maxWindow);
+    }
+    else
+        m_listenWindow = qMax(1, m_listenWindow / 2);
+
+    LinRttStats stats;
+    stats.name = "listen window";
+    stats.samples = m_predictionHits;
+    stats.srtt = m_listenWindow;
+    stats.rttvar = 0;
+    stats.timeout = m_listenWindow;
+    emit rttUpdated(stats);
+}
+
+RttEstimator &LinTransactionEngine::estimator(const LinCommand *command)
+{
+    QHash<const LinCommand*, RttEstimator>::iterator it = m_rtt.find(command);
+    if (it == m_rtt.end())
+        it = m_rtt.insert(command, RttEstimator(command->timeout));
+    return it.value();
+}
+
+void LinTransactionEngine::emitStats(const QString &name, const RttEstimator &estimator)
+{
+    LinRttStats stats;
+    stats.name = name;
+    stats.samples = estimator.samples();
+    stats.srtt = estimator.srtt();
+    stats.rttvar = estimator.rttvar();
+    stats.timeout = estimator.timeout();
+    emit rttUpdated(stats);
+}
+
+void LinTransactionEngine::startNext()
+{
+    if (m_queue.isEmpty())
+    {
+        // BETWEEN REQUESTS LISTEN TO CONTROLLER VALUES FRAMES
+        m_worker->setProtocol(LinFrameDecoder::ControllerProtocol);
+        return;
+    }
+    m_current = m_queue.dequeue();
+    start();
+}
+
+void LinTransactionEngine::start()
+{
+    const LinCommand *command = m_current.request.command;
+    m_worker->setProtocol(command->protocol);
+    if (command->protocol != LinFrameDecoder::ControllerProtocol)
+        m_lastValuesFrame.invalidate();
+    if (command->waitValuesFrame && !m_current.handshake && isInListenWindow())
+    {
+        m_current.predicted = true;
+        send();
+    }
+    else if (command->waitValuesFrame)
+    {
+        // FIRST OF VALUES FRAME AND PREDICTED SEND POINT
+        m_state = WaitValuesFrame;
+        m_current.predicted = false;
+        m_timer.start((!m_current.handshake && isPredictable()) ? predictedSendDelay() : m_valuesPeriod.timeout());
+    }
+    else
+        send();
+}
+
+void LinTransactionEngine::send()
+{
+    m_current.attempt++;
+    m_state = WaitEcho;
+    m_worker->write(m_current.request.frame);
+    m_sentTime.start();
+    m_timer.start(estimator(m_current.request.command).timeout());
+    emit requestSent(m_current.id);
+}
+
+void LinTransactionEngine::finish(LinReply::Error error, const LinFrame &frame)
+{
+    m_timer.stop();
+    if (m_current.predicted)
+    {
+        m_current.predicted = false;
+        bool missed = (error == LinReply::EchoNotReceived) || (error == LinReply::NoResponse);
+        predictionDone(!missed);
+        if (missed)
+        {
+            // NOT COUNTED AS ATTEMPT, REQUEST IS SENT AGAIN AFTER VALUES FRAME
+            m_current.attempt--;
+            m_current.handshake = true;
+            start();
+            return;
+        }
+    }
+    bool retriable = (error == LinReply::EchoNotReceived) || (error == LinReply::NoResponse) || (error == LinReply::ChecksumError);
+    if (retriable && (m_current.attempt <= m_current.request.command->retries))
+    {
+        start();
+        return;
+    }
+
+    int elapsed = (m_state == WaitValuesFrame) ? 0 : static_cast<int>(m_sentTime.elapsed());
+    if ((error == LinReply::NoError) && (m_current.attempt == 1))
+    {
+        RttEstimator &rtt = estimator(m_current.request.command);
+        rtt.addSample(elapsed);
+        emitStats(m_current.request.command->name, rtt);
+    }
+    m_state = Idle;
+    emit requestFinished(m_current.id, error, frame, elapsed, m_current.attempt);
+
+    if ((error != LinReply::NoError) && (m_current.request.batch != 0))
+    {
+        for (int i = 0; i < m_queue.size(); )
+        {
+            if (m_queue.at(i).request.batch == m_current.request.batch)
+                emit requestFinished(m_queue.takeAt(i).id, LinReply::Aborted, LinFrame(), 0, 0);
+            else
+                i++;
+        }
+    }
+    startNext();
+}
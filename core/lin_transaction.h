@@ -0,0 +1,235 @@
+#ifndef LIN_TRANSACTION_H
+#define LIN_TRANSACTION_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QQueue>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QHash>
+
+#include "lin_frame_decoder.h"
+#include "rtt_estimator.h"
+
+class SerialWorker;
+
+#define LIN_VALUES_FRAME_TIMEOUT    2000    // UNTIL PERIOD OF VALUES FRAMES IS LEARNED
+#define LIN_PERIOD_MIN_SAMPLES      4       // BEFORE CONTROLLER COMMANDS ARE SENT BY PREDICTION
+#define LIN_PERIOD_CHANGE_SAMPLES   3       // LONGER PERIODS IN A ROW AFTER WHICH PERIOD IS LEARNED AGAIN
+#define LIN_LISTEN_WINDOW           20      // MS AFTER VALUES FRAME CONTROLLER IS SURELY LISTENING, INITIAL
+
+// Exchange rules of one command type. Bootloader answers with first frame after echo,
+// controller answer is first frame with response code (values frames go between).
+struct LinCommand
+{
+    const char *name;
+    uint8_t protocol;       // LinFrameDecoder::Protocol OF REQUEST AND RESPONSE
+    uint8_t responseCode;
+    int responseSize;
+    int timeout;            // MS FROM WRITE TO RESPONSE, UNTIL ROUND TRIP TIME IS LEARNED
+    int retries;            // RESENDS AFTER LOST ECHO, LOST RESPONSE OR CHECKSUM ERROR
+    bool waitValuesFrame;   // CONTROLLER LISTENS ONLY RIGHT AFTER IT SENT VALUES FRAME
+};
+
+extern const LinCommand flashReadCommand;
+extern const LinCommand flashWriteCommand;
+extern const LinCommand readSettingsCommand;
+extern const LinCommand writeSettingsCommand;
+extern const LinCommand writeSettingsChunkCommand;
+extern const LinCommand eepromWriteCommand;
+extern const LinCommand eepromReadCommand;
+extern const LinCommand extPositionsCommand;
+extern const LinCommand clearErrorsCommand;
+
+struct LinRequest
+{
+    LinRequest() : command(0), batch(0) {}
+    LinRequest(const LinCommand *requestCommand, const QByteArray &requestFrame, int requestBatch = 0) :
+        command(requestCommand), frame(requestFrame), batch(requestBatch) {}
+
+    const LinCommand *command;
+    QByteArray frame;
+    int batch;              // 0 - SINGLE REQUEST, ELSE FAILED REQUEST ABORTS REST OF BATCH
+};
+
+Q_DECLARE_METATYPE(LinRequest)
+
+// Learned timing of one command type (or of values frames period), for display.
+struct LinRttStats
+{
+    QString name;
+    int samples;
+    double srtt;            // MS
+    double rttvar;
+    int timeout;
+};
+
+Q_DECLARE_METATYPE(LinRttStats)
+
+// Result of submitted request, lives in thread of LinLink owner. Can be deleted at any
+// time, request is then still processed but result dropped.
+class LinReply : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 1..4 ARE SAME AS OLD sendFrameAndWaitAck() CODES
+    enum Error
+    {
+        NoError = 0,
+        NoValuesFrame = 1,
+        EchoNotReceived = 2,
+        NoResponse = 3,
+        ChecksumError = 4,
+        BadResponse,
+        Aborted
+    };
+
+    explicit LinReply(const LinRequest &request, QObject *parent = 0);
+
+    const LinRequest &request() const { return m_request; }
+
+    bool isFinished() const { return m_finished; }
+
+    Error error() const { return m_error; }
+
+    const LinFrame &frame() const { return m_frame; }
+
+    // MS FROM LAST WRITE TO RESPONSE
+    int elapsed() const { return m_elapsed; }
+
+    int attempts() const { return m_attempts; }
+
+    // RUNS LOCAL EVENT LOOP, RETURNS IMMEDIATELY IF ALREADY FINISHED
+    void waitForFinished();
+
+signals:
+
+    void sent();
+
+    void finished();
+
+private:
+    friend class LinLink;
+
+    void markSent();
+
+    void complete(int error, const LinFrame &frame, int elapsed, int attempts);
+
+    LinRequest m_request;
+
+    bool m_finished;
+
+    Error m_error;
+
+    LinFrame m_frame;
+
+    int m_elapsed;
+
+    int m_attempts;
+};
+
+// Runs requests one by one in I/O thread. Fed directly by decoder, so request is
+// completed in the same call that decoded its response frame.
+class LinTransactionEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LinTransactionEngine(SerialWorker *worker);
+
+public slots:
+
+    void submit(quint64 id, const LinRequest &request);
+
+    // FINISHES ALL QUEUED AND CURRENT REQUESTS WITH Aborted
+    void abortAll();
+
+    // NEW PORT OR ADAPTER, LEARNING STARTS FROM CONFIGURED TIMEOUTS
+    void resetEstimates();
+
+    void frameReceived(const LinFrame &frame);
+
+    void checksumError(const LinFrame &frame);
+
+signals:
+
+    void requestSent(quint64 id);
+
+    void requestFinished(quint64 id, int error, const LinFrame &frame, int elapsed, int attempts);
+
+    void rttUpdated(const LinRttStats &stats);
+
+private slots:
+
+    void timeout();
+
+private:
+    enum State
+    {
+        Idle,
+        WaitValuesFrame,
+        WaitEcho,
+        WaitResponse
+    };
+
+    struct Pending
+    {
+        quint64 id;
+        LinRequest request;
+        int attempt;
+        bool predicted;     // SENT WITHOUT SEEING VALUES FRAME
+        bool handshake;     // PREDICTION MISSED, WAIT VALUES FRAME
+    };
+
+    SerialWorker *m_worker;
+
+    QQueue<Pending> m_queue;
+
+    Pending m_current;
+
+    State m_state;
+
+    QTimer m_timer;
+
+    QElapsedTimer m_sentTime;
+
+    QHash<const LinCommand*, RttEstimator> m_rtt;
+
+    // PERIOD OF CONTROLLER VALUES FRAMES, BOUNDS WAIT BEFORE CONTROLLER COMMANDS
+    RttEstimator m_valuesPeriod;
+
+    QElapsedTimer m_lastValuesFrame;
+
+    // PERIODS IN A ROW TAKEN AS LOST FRAMES
+    int m_longPeriods;
+
+    // LEARNED AS AIMD: GROWS BY 1 MS AFTER HIT, HALVED AFTER MISS
+    int m_listenWindow;
+
+    int m_predictionHits;
+
+    bool isPredictable() const;
+
+    bool isInListenWindow() const;
+
+    // MS TILL SEND POINT AFTER NEXT PREDICTED VALUES FRAME
+    int predictedSendDelay() const;
+
+    void predictionDone(bool hit);
+
+    RttEstimator &estimator(const LinCommand *command);
+
+    void emitStats(const QString &name, const RttEstimator &estimator);
+
+    void startNext();
+
+    void start();
+
+    void send();
+
+    void finish(LinReply::Error error, const LinFrame &frame = LinFrame());
+};
+
+#endif // LIN_TRANSACTION_H
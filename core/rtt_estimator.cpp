@@ -0,0 +1,45 @@
+#include "rtt_estimator.h"
+
+#include <QtGlobal>
+
+RttEstimator::RttEstimator(int initialTimeout) :
+    m_initialTimeout(initialTimeout)
+{
+    reset();
+}
+
+void RttEstimator::reset()
+{
+    m_samples = 0;
+    m_srtt = 0;
+    m_rttvar = 0;
+    m_backoff = 1;
+}
+
+void RttEstimator::addSample(int rtt)
+{
+    if (m_samples == 0)
+    {
+        m_srtt = rtt;
+        m_rttvar = rtt / 2.0;
+    }
+    else
+    {
+        m_rttvar += (qAbs(m_srtt - rtt) - m_rttvar) / 4;
+        m_srtt += (rtt - m_srtt) / 8;
+    }
+    m_samples++;
+    m_backoff = 1;
+}
+
+void RttEstimator::backoff()
+{
+    if (timeout() < maxTimeout())
+        m_backoff *= 2;
+}
+
+int RttEstimator::timeout() const
+{
+    int base = (m_samples == 0) ? m_initialTimeout : qMax(LIN_MIN_TIMEOUT, qRound(m_srtt + 4 * m_rttvar));
+    return qMin(base * m_backoff, maxTimeout());
+}
@@ -0,0 +1,44 @@
+#ifndef RTT_ESTIMATOR_H
+#define RTT_ESTIMATOR_H
+
+#define LIN_MIN_TIMEOUT         30  // MS, FLOOR OF LEARNED TIMEOUT
+#define LIN_MAX_TIMEOUT_FACTOR  4   // LEARNED TIMEOUT IS AT MOST CONFIGURED ONE MULTIPLIED BY IT
+
+// Round trip time of one command type smoothed as in TCP (RFC 6298): SRTT and RTTVAR with
+// gains 1/8 and 1/4, timeout is SRTT + 4 * RTTVAR. Configured timeout is used until first
+// sample, every expired timeout doubles current one up to the limit.
+class RttEstimator
+{
+public:
+    explicit RttEstimator(int initialTimeout = 1000);
+
+    void reset();
+
+    // ONLY FOR FIRST ATTEMPTS, ANSWER TO RESENT REQUEST IS AMBIGUOUS
+    void addSample(int rtt);
+
+    void backoff();
+
+    int timeout() const;
+
+    int maxTimeout() const { return m_initialTimeout * LIN_MAX_TIMEOUT_FACTOR; }
+
+    int samples() const { return m_samples; }
+
+    double srtt() const { return m_srtt; }
+
+    double rttvar() const { return m_rttvar; }
+
+private:
+    int m_initialTimeout;
+
+    int m_samples;
+
+    double m_srtt;
+
+    double m_rttvar;
+
+    int m_backoff;
+};
+
+#endif // RTT_ESTIMATOR_H
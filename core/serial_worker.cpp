@@ -0,0 +1,68 @@
+#include "serial_worker.h"
+
+#include <QtSerialPort/qserialport.h>
+
+SerialWorker::SerialWorker(const RawDataHandler &rawDataHandler) :
+    QObject(0),
+    m_port(0),
+    m_decoder(this),
+    m_rawDataHandler(rawDataHandler)
+{
+    m_engine = new LinTransactionEngine(this);
+    connect(&m_decoder, &LinFrameDecoder::frameReceived, m_engine, &LinTransactionEngine::frameReceived);
+    connect(&m_decoder, &LinFrameDecoder::checksumError, m_engine, &LinTransactionEngine::checksumError);
+    connect(&m_decoder, &LinFrameDecoder::frameReceived, this, &SerialWorker::frameReceived);
+    connect(&m_decoder, &LinFrameDecoder::checksumError, this, &SerialWorker::checksumError);
+}
+
+bool SerialWorker::open(const QString &portName, int baudRate)
+{
+    if (m_port == 0)
+    {
+        m_port = new QSerialPort(this);
+        connect(m_port, &QSerialPort::readyRead, this, &SerialWorker::readData);
+    }
+    if (m_port->isOpen())
+        m_port->close();
+    m_port->setPortName(portName);
+    if (!m_port->open(QSerialPort::ReadWrite))
+        return false;
+    m_port->setParity(QSerialPort::NoParity);
+    m_port->setDataBits(QSerialPort::Data8);
+    m_port->setStopBits(QSerialPort::OneStop);
+    m_port->setFlowControl(QSerialPort::NoFlowControl);
+    m_port->setBaudRate(baudRate);
+    m_decoder.reset();
+    m_decoder.resetStats();
+    return true;
+}
+
+LinDecoderStats SerialWorker::close()
+{
+    if ((m_port != 0) && m_port->isOpen())
+        m_port->close();
+    return m_decoder.stats();
+}
+
+void SerialWorker::write(const QByteArray &data)
+{
+    if ((m_port != 0) && m_port->isOpen())
+        m_port->write(data);
+}
+
+void SerialWorker::setProtocol(int protocol)
+{
+    m_decoder.setProtocol(static_cast<LinFrameDecoder::Protocol>(protocol));
+}
+
+void SerialWorker::readData()
+{
+    char receivedData[256];
+    qint64 receivedSize;
+    while ((receivedSize = m_port->read(receivedData, sizeof(receivedData))) > 0)
+    {
+        if (m_rawDataHandler)
+            m_rawDataHandler(receivedData, receivedSize);
+        m_decoder.push(receivedData, receivedSize);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef SERIAL_WORKER_H
+#define SERIAL_WORKER_H
+
+#include <QObject>
+#include <QByteArray>
+
+#include <functional>
+
+#include "lin_frame_decoder.h"
+#include "lin_transaction.h"
+
+class QSerialPort;
+
+// Owns serial port and frame decoder, lives in serial I/O thread. All slots are called
+// by queued connections from LinLink, decoded frames are sent back by queued signals.
+class SerialWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // CALLED IN I/O THREAD FOR EVERY BLOCK OF RECEIVED BYTES
+    typedef std::function<void(const char *data, int size)> RawDataHandler;
+
+    explicit SerialWorker(const RawDataHandler &rawDataHandler = RawDataHandler());
+
+    LinTransactionEngine *engine() { return m_engine; }
+
+public slots:
+
+    bool open(const QString &portName, int baudRate);
+
+    LinDecoderStats close();
+
+    void write(const QByteArray &data);
+
+    void setProtocol(int protocol);
+
+signals:
+
+    void frameReceived(const LinFrame &frame);
+
+    void checksumError(const LinFrame &frame);
+
+private slots:
+
+    void readData();
+
+private:
+    QSerialPort *m_port;
+
+    LinFrameDecoder m_decoder;
+
+    LinTransactionEngine *m_engine;
+
+    RawDataHandler m_rawDataHandler;
+};
+
+#endif // SERIAL_WORKER_H
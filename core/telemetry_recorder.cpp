@@ -0,0 +1,250 @@
+#include "telemetry_recorder.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <string.h>
+
+static QString segmentFileName(const QString &recordingDirectory, quint32 segment)
+{
+    return QString("%1/segment-%2.tlm").arg(recordingDirectory).arg(segment, 4, 10, QChar('0'));
+}
+
+TelemetryRecorder::TelemetryRecorder(const QString &directory) :
+    m_directory(directory),
+    m_header(0),
+    m_records(0),
+    m_startTime(0),
+    m_lastTime(0),
+    m_sequence(0),
+    m_segment(0)
+{
+}
+
+TelemetryRecorder::~TelemetryRecorder()
+{
+    stop();
+}
+
+void TelemetryRecorder::setDirectory(const QString &directory)
+{
+    stop();
+    m_directory = directory;
+}
+
+QString TelemetryRecorder::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/telemetry";
+}
+
+bool TelemetryRecorder::start()
+{
+    stop();
+    QDateTime now = QDateTime::currentDateTime();
+    m_recordingDirectory = m_directory + "/" + now.toString("yyyyMMdd-hhmmss-zzz");
+    if (!QDir().mkpath(m_recordingDirectory))
+        return false;
+    m_startTime = now.toMSecsSinceEpoch();
+    m_lastTime = 0;
+    m_sequence = 0;
+    m_segment = 0;
+    m_clock.start();
+    return openSegment();
+}
+
+void TelemetryRecorder::stop()
+{
+    closeSegment();
+}
+
+bool TelemetryRecorder::append(const char *data)
+{
+    if (m_header == 0)
+        return false;
+    if (m_header->count == m_header->capacity)
+    {
+        closeSegment();
+        m_segment++;
+        if (!openSegment())
+            return false;
+    }
+
+    // ELAPSED TIMER IS MONOTONIC, EQUAL TIMES ARE KEPT IN ORDER BY SEQUENCE
+    qint64 time = qMax(m_clock.nsecsElapsed() / 1000, m_lastTime);
+    TelemetryRecord &record = m_records[m_header->count];
+    record.time = time;
+    record.sequence = m_sequence++;
+    memcpy(record.data, data, TELEMETRY_DATA_SIZE);
+    memset(record.reserved, 0, sizeof(record.reserved));
+
+    if (m_header->count == 0)
+        m_header->firstTime = time;
+    m_header->lastTime = time;
+    m_header->count++;
+    m_lastTime = time;
+    return true;
+}
+
+bool TelemetryRecorder::append(const LinFrame &frame)
+{
+    if ((frame.protocol != LinFrameDecoder::ControllerProtocol) || (frame.code != VALUES_FRAME_CODE) || (frame.size != CURRENT_DATA_SIZE))
+        return false;
+    return append(frame.data() + 2);
+}
+
+bool TelemetryRecorder::openSegment()
+{
+    m_file.setFileName(segmentFileName(m_recordingDirectory, m_segment));
+    qint64 size = sizeof(TelemetrySegmentHeader) + qint64(TELEMETRY_SEGMENT_RECORDS) * sizeof(TelemetryRecord);
+    if (!m_file.open(QFile::ReadWrite | QFile::Truncate) || !m_file.resize(size))
+    {
+        m_file.close();
+        return false;
+    }
+    uchar *map = m_file.map(0, size);
+    if (map == 0)
+    {
+        m_file.close();
+        return false;
+    }
+
+    m_header = reinterpret_cast<TelemetrySegmentHeader*>(map);
+    m_records = reinterpret_cast<TelemetryRecord*>(map + sizeof(TelemetrySegmentHeader));
+    memset(m_header, 0, sizeof(TelemetrySegmentHeader));
+    strncpy(m_header->magic, TELEMETRY_SEGMENT_MAGIC, sizeof(m_header->magic));
+    m_header->recordSize = sizeof(TelemetryRecord);
+    m_header->capacity = TELEMETRY_SEGMENT_RECORDS;
+    m_header->startTime = m_startTime;
+    m_header->segment = m_segment;
+    return true;
+}
+
+void TelemetryRecorder::closeSegment()
+{
+    if (m_header == 0)
+        return;
+    qint64 size = sizeof(TelemetrySegmentHeader) + qint64(m_header->count) * sizeof(TelemetryRecord);
+    m_file.unmap(reinterpret_cast<uchar*>(m_header));
+    m_header = 0;
+    m_records = 0;
+    m_file.resize(size);
+    m_file.close();
+}
+
+TelemetryReader::TelemetryReader() :
+    m_count(0),
+    m_startTime(0)
+{
+}
+
+TelemetryReader::~TelemetryReader()
+{
+    close();
+}
+
+QStringList TelemetryReader::recordings(const QString &directory)
+{
+    QDir dir(directory);
+    QStringList result;
+    // NAMES ARE START TIMES, SO NAME ORDER IS TIME ORDER
+    for (const QString &name : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+        result.append(dir.absoluteFilePath(name));
+    return result;
+}
+
+bool TelemetryReader::open(const QString &recordingDirectory)
+{
+    close();
+    for (quint32 i = 0; ; i++)
+    {
+        QFile *file = new QFile(segmentFileName(recordingDirectory, i));
+        if (!file->open(QFile::ReadOnly) || (file->size() < qint64(sizeof(TelemetrySegmentHeader))))
+        {
+            delete file;
+            break;
+        }
+        const uchar *map = file->map(0, file->size());
+        const TelemetrySegmentHeader *header = reinterpret_cast<const TelemetrySegmentHeader*>(map);
+        // SEGMENT BEING RECORDED CAN GROW, ONLY RECORDS COUNTED AT OPEN ARE USED
+        if ((map == 0) || (strncmp(header->magic, TELEMETRY_SEGMENT_MAGIC, sizeof(header->magic)) != 0)
+                || (header->recordSize != sizeof(TelemetryRecord))
+                || (file->size() < qint64(sizeof(TelemetrySegmentHeader) + qint64(header->count) * sizeof(TelemetryRecord))))
+        {
+            delete file;
+            break;
+        }
+        if (header->count == 0)
+        {
+            delete file;
+            continue;
+        }
+
+        Segment segment;
+        segment.file = file;
+        segment.records = reinterpret_cast<const TelemetryRecord*>(map + sizeof(TelemetrySegmentHeader));
+        segment.first = m_count;
+        segment.count = header->count;
+        segment.firstTime = header->firstTime;
+        segment.lastTime = header->lastTime;
+        m_startTime = header->startTime;
+        m_segments.append(segment);
+        m_count += segment.count;
+    }
+    return isOpen();
+}
+
+void TelemetryReader::close()
+{
+    for (const Segment &segment : m_segments)
+        delete segment.file;
+    m_segments.clear();
+    m_count = 0;
+    m_startTime = 0;
+}
+
+qint64 TelemetryReader::firstTime() const
+{
+    return m_segments.isEmpty() ? 0 : m_segments.first().firstTime;
+}
+
+qint64 TelemetryReader::lastTime() const
+{
+    return m_segments.isEmpty() ? 0 : m_segments.last().lastTime;
+}
+
+const TelemetryRecord &TelemetryReader::record(quint64 index) const
+{
+    const Segment &segment = m_segments.at(segmentOf(index));
+    return segment.records[index - segment.first];
+}
+
+quint64 TelemetryReader::seek(qint64 time) const
+{
+    for (const Segment &segment : m_segments)
+    {
+        if (segment.lastTime < time)
+            continue;
+        const TelemetryRecord *end = segment.records + segment.count;
+        const TelemetryRecord *found = std::lower_bound(segment.records, end, time,
+                                                        [](const TelemetryRecord &record, qint64 value) { return record.time < value; });
+        return segment.first + (found - segment.records);
+    }
+    return m_count;
+}
+
+int TelemetryReader::segmentOf(quint64 index) const
+{
+    int low = 0;
+    int high = m_segments.size() - 1;
+    while (low < high)
+    {
+        int middle = (low + high + 1) / 2;
+        if (m_segments.at(middle).first <= index)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
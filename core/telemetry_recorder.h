@@ -0,0 +1,150 @@
+#ifndef TELEMETRY_RECORDER_H
+#define TELEMETRY_RECORDER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "lin_frame_decoder.h"
+
+#define TELEMETRY_DATA_SIZE         (CURRENT_DATA_SIZE - 3)
+#define TELEMETRY_SEGMENT_RECORDS   65536
+#define TELEMETRY_SEGMENT_MAGIC     "LINTLM1"
+
+// ONE VALUES FRAME, NATIVE BYTE ORDER
+struct TelemetryRecord
+{
+    qint64 time;        // US SINCE RECORDING START, MONOTONIC CLOCK
+    quint32 sequence;
+    uint8_t data[TELEMETRY_DATA_SIZE];
+    uint8_t reserved[4];
+};
+
+Q_STATIC_ASSERT(sizeof(TelemetryRecord) == 32);
+
+struct TelemetrySegmentHeader
+{
+    char magic[8];
+    quint32 recordSize;
+    quint32 capacity;
+    qint64 startTime;   // MS SINCE EPOCH WHEN RECORDING STARTED
+    qint64 firstTime;
+    qint64 lastTime;
+    quint32 count;      // UPDATED AFTER RECORD IS IN PLACE
+    quint32 segment;
+    uint8_t reserved[16];
+};
+
+Q_STATIC_ASSERT(sizeof(TelemetrySegmentHeader) == 64);
+
+// Append-only recorder of values frames (0x35). Each recording is directory of segment files
+// of fixed 32-byte records; segment is created at full size and written through memory map,
+// so append is one copy without system call. Record count in header is updated last, so
+// killed program leaves readable segment. Unused tail is cut when segment is closed.
+class TelemetryRecorder
+{
+public:
+    explicit TelemetryRecorder(const QString &directory = defaultDirectory());
+    ~TelemetryRecorder();
+
+    QString directory() const { return m_directory; }
+
+    void setDirectory(const QString &directory);
+
+    static QString defaultDirectory();
+
+    // NEW RECORDING IN SUBDIRECTORY NAMED BY START TIME
+    bool start();
+
+    void stop();
+
+    bool isRecording() const { return m_header != 0; }
+
+    QString recordingDirectory() const { return m_recordingDirectory; }
+
+    quint32 records() const { return m_sequence; }
+
+    // VALUES FRAME DATA WITHOUT SYNC, CODE AND CHECKSUM
+    bool append(const char *data);
+
+    bool append(const LinFrame &frame);
+
+private:
+    QString m_directory;
+
+    QString m_recordingDirectory;
+
+    QFile m_file;
+
+    TelemetrySegmentHeader *m_header;
+
+    TelemetryRecord *m_records;
+
+    QElapsedTimer m_clock;
+
+    qint64 m_startTime;
+
+    qint64 m_lastTime;
+
+    quint32 m_sequence;
+
+    quint32 m_segment;
+
+    bool openSegment();
+
+    void closeSegment();
+};
+
+// Read-only view of recording. Segment table (first record, first and last time of each
+// segment) is index for time seeks, inside segment records are found by binary search.
+class TelemetryReader
+{
+public:
+    TelemetryReader();
+    ~TelemetryReader();
+
+    // RECORDINGS IN DIRECTORY, OLDEST FIRST
+    static QStringList recordings(const QString &directory);
+
+    bool open(const QString &recordingDirectory);
+
+    void close();
+
+    bool isOpen() const { return !m_segments.isEmpty(); }
+
+    quint64 count() const { return m_count; }
+
+    qint64 startTime() const { return m_startTime; }
+
+    qint64 firstTime() const;
+
+    qint64 lastTime() const;
+
+    const TelemetryRecord &record(quint64 index) const;
+
+    // FIRST RECORD WITH TIME NOT BEFORE GIVEN, count() IF NONE
+    quint64 seek(qint64 time) const;
+
+private:
+    struct Segment
+    {
+        QFile *file;
+        const TelemetryRecord *records;
+        quint64 first;
+        quint32 count;
+        qint64 firstTime;
+        qint64 lastTime;
+    };
+
+    QVector<Segment> m_segments;
+
+    quint64 m_count;
+
+    qint64 m_startTime;
+
+    int segmentOf(quint64 index) const;
+};
+
+#endif // TELEMETRY_RECORDER_H
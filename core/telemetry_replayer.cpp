@@ -0,0 +1,97 @@
+#include "telemetry_replayer.h"
+
+#include <string.h>
+
+TelemetryReplayer::TelemetryReplayer(QObject *parent) :
+    QObject(parent),
+    m_running(false),
+    m_speed(1.0),
+    m_next(0),
+    m_end(0),
+    m_firstTime(0)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &TelemetryReplayer::replayNext);
+}
+
+bool TelemetryReplayer::open(const QString &recordingDirectory)
+{
+    stop();
+    return m_reader.open(recordingDirectory);
+}
+
+void TelemetryReplayer::start(double speed, qint64 fromTime, qint64 toTime)
+{
+    stop();
+    m_speed = qMax(speed, 0.0);
+    m_next = m_reader.seek(fromTime);
+    m_end = (toTime < 0) ? m_reader.count() : m_reader.seek(toTime + 1);
+    if (m_next >= m_end)
+    {
+        emit finished();
+        return;
+    }
+    m_firstTime = m_reader.record(m_next).time;
+    m_clock.start();
+    m_running = true;
+    m_timer.start(0);
+}
+
+void TelemetryReplayer::stop()
+{
+    // FRAME RECEIVER CAN STOP REPLAY FROM SLOT
+    m_running = false;
+    m_timer.stop();
+}
+
+LinFrame TelemetryReplayer::toFrame(const TelemetryRecord &record)
+{
+    LinFrame frame;
+    frame.protocol = LinFrameDecoder::ControllerProtocol;
+    frame.code = VALUES_FRAME_CODE;
+    frame.size = CURRENT_DATA_SIZE;
+    frame.bytes[0] = LIN_SYNC_BYTE;
+    frame.bytes[1] = VALUES_FRAME_CODE;
+    memcpy(frame.bytes + 2, record.data, TELEMETRY_DATA_SIZE);
+    uint8_t sum = 0;
+    for (int i = 1; i < (CURRENT_DATA_SIZE - 1); i++)
+        sum += frame.bytes[i];
+    frame.bytes[CURRENT_DATA_SIZE - 1] = sum;
+    return frame;
+}
+
+void TelemetryReplayer::replayNext()
+{
+    if (m_speed == 0)
+    {
+        for (int i = 0; m_running && (i < TELEMETRY_REPLAY_BATCH) && (m_next < m_end); i++)
+            emit frameReplayed(toFrame(m_reader.record(m_next++)));
+        if (!m_running)
+            return;
+        if (m_next < m_end)
+            m_timer.start(0);
+        else
+            finish();
+        return;
+    }
+
+    qint64 elapsed = static_cast<qint64>(m_clock.nsecsElapsed() / 1000 * m_speed);
+    while (m_running && (m_next < m_end) && ((m_reader.record(m_next).time - m_firstTime) <= elapsed))
+        emit frameReplayed(toFrame(m_reader.record(m_next++)));
+    if (!m_running)
+        return;
+    if (m_next >= m_end)
+    {
+        finish();
+        return;
+    }
+    qint64 wait = static_cast<qint64>((m_reader.record(m_next).time - m_firstTime - elapsed) / m_speed);
+    m_timer.start(static_cast<int>(qMax<qint64>(wait / 1000, 0)));
+}
+
+void TelemetryReplayer::finish()
+{
+    m_running = false;
+    emit finished();
+}
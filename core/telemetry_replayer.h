@@ -0,0 +1,65 @@
+#ifndef TELEMETRY_REPLAYER_H
+#define TELEMETRY_REPLAYER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include "telemetry_recorder.h"
+
+#define TELEMETRY_REPLAY_BATCH  256
+
+// Plays recording back as values frames, same as LinLink::frameReceived would emit them, so
+// GUI decodes replayed and live frames by one path. Speed 1 keeps recorded timing (scaled for
+// other speeds), speed 0 replays as fast as possible in batches between event loop passes.
+class TelemetryReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TelemetryReplayer(QObject *parent = 0);
+
+    bool open(const QString &recordingDirectory);
+
+    const TelemetryReader &reader() const { return m_reader; }
+
+    // TIMES IN US SINCE RECORDING START, NEGATIVE END IS END OF RECORDING
+    void start(double speed = 1.0, qint64 fromTime = 0, qint64 toTime = -1);
+
+    void stop();
+
+    bool isRunning() const { return m_running; }
+
+    static LinFrame toFrame(const TelemetryRecord &record);
+
+signals:
+
+    void frameReplayed(const LinFrame &frame);
+
+    void finished();
+
+private slots:
+
+    void replayNext();
+
+private:
+    TelemetryReader m_reader;
+
+    QTimer m_timer;
+
+    QElapsedTimer m_clock;
+
+    bool m_running;
+
+    double m_speed;
+
+    quint64 m_next;
+
+    quint64 m_end;
+
+    qint64 m_firstTime;
+
+    void finish();
+};
+
+#endif // TELEMETRY_REPLAYER_H
@@ -0,0 +1,301 @@
+#include "device_emulator.h"
+#include "pty_port.h"
+#include "hex_converter.h"
+#include "controller_settings.h"
+
+#include <QFile>
+#include <QTime>
+
+#include <stdio.h>
+
+DeviceEmulator::DeviceEmulator(PtyPort *port, Mode mode, QObject *parent) :
+    QObject(parent),
+    m_port(port),
+    m_mode(mode),
+    m_decoder(this),
+    m_latency(2),
+    m_jitter(0),
+    m_corruptRate(0),
+    m_verbose(false),
+    m_valuesTimer(this),
+    m_listenWindow(0),
+    m_extControl(false),
+    m_adcValue(0),
+    m_adcStep(1),
+    m_errors(0),
+    m_counter(0)
+{
+    for (int i = 0; i < EMULATOR_FLASH_WORDS; i++)
+        m_flash[i] = EMULATOR_ERASED_WORD;
+    m_flash[wordIndex(FLASH_CONFIG_ADDRESS + 6)] = EMULATOR_DEVICE_ID;
+
+    // SAME AS DEFAULT SETTINGS OF TOOL
+    m_settings = defaultSettings();
+    m_eeprom = m_settings;
+    m_extValues[0] = m_extValues[1] = 0;
+    m_readValues[0] = m_readValues[1] = 0;
+
+    m_decoder.setProtocol((mode == BootloaderMode) ? LinFrameDecoder::BootloaderProtocol : LinFrameDecoder::ControllerProtocol);
+    connect(&m_decoder, &LinFrameDecoder::frameReceived, this, &DeviceEmulator::frameReceived);
+    connect(m_port, &PtyPort::dataReceived, this, &DeviceEmulator::dataReceived);
+
+    m_valuesTimer.setInterval(100);
+    m_valuesTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_valuesTimer, &QTimer::timeout, this, &DeviceEmulator::sendValuesFrame);
+}
+
+QString DeviceEmulator::loadImage(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+        return QString("Can't open %1").arg(fileName);
+    QByteArray contents = file.readAll();
+    FlashImage image;
+    QString error = hexFileToImage(contents.constData(), contents.size(), &image);
+    if (!error.isEmpty())
+        return error;
+    for (FlashImage::Row row : image)
+    {
+        for (int i = 0; i < FLASH_ROW_WORDS; i++)
+        {
+            int index = wordIndex(row.address + i);
+            if (index >= 0)
+                m_flash[index] = image.word(row.address + i) & EMULATOR_ERASED_WORD;
+        }
+    }
+    return QString();
+}
+
+void DeviceEmulator::setUserId(uint16_t userId)
+{
+    m_flash[wordIndex(FLASH_CONFIG_ADDRESS)] = userId & EMULATOR_ERASED_WORD;
+}
+
+void DeviceEmulator::setDeviceId(uint16_t deviceId)
+{
+    m_flash[wordIndex(FLASH_CONFIG_ADDRESS + 6)] = deviceId & EMULATOR_ERASED_WORD;
+}
+
+void DeviceEmulator::setLatency(int latency, int jitter)
+{
+    m_latency = latency;
+    m_jitter = jitter;
+}
+
+void DeviceEmulator::start()
+{
+    if (m_mode == ControllerMode)
+        m_valuesTimer.start();
+}
+
+void DeviceEmulator::dataReceived(const QByteArray &data)
+{
+    // LIN TRANSCEIVER LOOPBACK
+    m_port->write(data);
+    m_decoder.push(data.constData(), data.size());
+}
+
+void DeviceEmulator::frameReceived(const LinFrame &frame)
+{
+    if (m_mode == BootloaderMode)
+        bootloaderFrame(frame);
+    else
+        controllerFrame(frame);
+}
+
+void DeviceEmulator::bootloaderFrame(const LinFrame &frame)
+{
+    if (frame.size < 6)
+        return;
+    int32_t address = frame.bytes[4] | (frame.bytes[5] << 8);
+    if ((frame.code == FLASH_READ_CODE) && (frame.size == 6))
+    {
+        QByteArray data(2 + FLASH_ROW_SIZE, 0);
+        data[0] = frame.bytes[4];
+        data[1] = frame.bytes[5];
+        for (int i = 0; i < FLASH_ROW_WORDS; i++)
+        {
+            int index = wordIndex(address + i);
+            uint16_t word = (index >= 0) ? m_flash[index] : 0;
+            data[2 + i * 2] = word & 0xFF;
+            data[3 + i * 2] = word >> 8;
+        }
+        log(QString("Flash read %1").arg(address, 4, 16, QChar('0')));
+        answerBootloader(FLASH_READ_ANSWER_CODE, data);
+    }
+    else if ((frame.code == FLASH_WRITE_CODE) && (frame.size == 6 + FLASH_ROW_SIZE))
+    {
+        for (int i = 0; i < FLASH_ROW_WORDS; i++)
+        {
+            int index = wordIndex(address + i);
+            // DEVICE ID AND REVISION ARE READ ONLY
+            if ((index < 0) || (address + i == FLASH_CONFIG_ADDRESS + 5) || (address + i == FLASH_CONFIG_ADDRESS + 6))
+                continue;
+            m_flash[index] = (frame.bytes[6 + i * 2] | (frame.bytes[7 + i * 2] << 8)) & EMULATOR_ERASED_WORD;
+        }
+        log(QString("Flash write %1").arg(address, 4, 16, QChar('0')));
+        answerBootloader(FLASH_WRITE_ANSWER_CODE, QByteArray());
+    }
+}
+
+void DeviceEmulator::controllerFrame(const LinFrame &frame)
+{
+    if (frame.size != COMMAND_FRAME_SIZE)
+        return;
+    if ((m_listenWindow > 0) && (!m_lastValuesFrame.isValid() || (m_lastValuesFrame.elapsed() > m_listenWindow)))
+    {
+        log(QString("Command %1 ignored, not listening").arg(frame.code, 2, 16, QChar('0')));
+        return;
+    }
+    const uint8_t *data = frame.bytes + 2;
+    if (frame.code <= 6)
+    {
+        int offset = frame.code * 8;
+        for (int i = 0; (i < 8) && (offset + i < m_settings.size()); i++)
+            m_settings[offset + i] = data[i];
+        log(QString("Settings part %1").arg(frame.code));
+    }
+    else if (frame.code == 0x10)
+    {
+        m_eeprom = m_settings;
+        log("EEPROM write");
+    }
+    else if (frame.code == 0x11)
+    {
+        m_settings = m_eeprom;
+        log("EEPROM read");
+    }
+    else if (frame.code == 0x12)
+    {
+        log("Read settings");
+        answerController(SETTINGS_FRAME_CODE, m_settings);
+        return;
+    }
+    else if (frame.code == 0x17)
+    {
+        m_extValues[0] = data[0] | (data[1] << 8);
+        m_extValues[1] = data[2] | (data[3] << 8);
+        m_extControl = (data[4] != 0);
+        log(QString("Ext positions %1 %2 %3").arg(m_extValues[0]).arg(m_extValues[1]).arg(m_extControl));
+    }
+    else if (frame.code == 0x18)
+    {
+        m_errors = 0;
+        log("Clear errors");
+    }
+    else
+        return;
+    answerController(ACK_FRAME_CODE, QByteArray(1, 0));
+}
+
+void DeviceEmulator::sendValuesFrame()
+{
+    int adc = m_adcValue + m_adcStep;
+    if ((adc < 0) || (adc > 255))
+        m_adcStep = -m_adcStep;
+    m_adcValue += m_adcStep;
+    m_counter++;
+    m_lastValuesFrame.start();
+
+    int index = positionIndex();
+    int mult = static_cast<uint8_t>(m_settings.at(2));
+    int16_t writtenValues[2];
+    for (int i = 0; i < 2; i++)
+    {
+        writtenValues[i] = m_extControl ? m_extValues[i] : static_cast<int8_t>(m_settings.at(22 + i * 16 + index)) * mult;
+        // MOTORS FOLLOW WRITTEN VALUE WITH LIMITED SPEED
+        int delta = qBound(-mult, writtenValues[i] - m_readValues[i], mult);
+        m_readValues[i] += delta;
+    }
+
+    QByteArray data(CURRENT_DATA_SIZE - 3, 0);
+    data[0] = 25 + (m_counter >> 6) % 3;
+    data[1] = m_adcValue;
+    data[2] = index;
+    for (int i = 0; i < 2; i++)
+    {
+        data[3 + i * 2] = m_readValues[i] & 0xFF;
+        data[4 + i * 2] = (m_readValues[i] >> 8) & 0xFF;
+        data[7 + i * 2] = writtenValues[i] & 0xFF;
+        data[8 + i * 2] = (writtenValues[i] >> 8) & 0xFF;
+    }
+    data[11] = 0x03 | (m_extControl ? 0x08 : 0);
+    data[12] = m_errors;
+    data[15] = m_errors;
+
+    QByteArray frame(1, LIN_SYNC_BYTE);
+    frame.append(VALUES_FRAME_CODE);
+    frame.append(data);
+    frame.append(char(0));
+    answer(frame, frame.size() - 1);
+}
+
+void DeviceEmulator::answerBootloader(uint8_t code, const QByteArray &data)
+{
+    QByteArray frame(4, 0);
+    frame[0] = LIN_SYNC_BYTE;
+    frame[1] = 2 + data.size();
+    frame[3] = code;
+    frame.append(data);
+    answer(frame, 2);
+}
+
+void DeviceEmulator::answerController(uint8_t code, const QByteArray &data)
+{
+    QByteArray frame(1, LIN_SYNC_BYTE);
+    frame.append(code);
+    frame.append(data);
+    frame.append(char(0));
+    answer(frame, frame.size() - 1);
+}
+
+void DeviceEmulator::answer(QByteArray frame, int checksumIndex)
+{
+    uint8_t sum = 0;
+    if (checksumIndex == 2)
+    {
+        for (int i = 3; i < frame.size(); i++)
+            sum += static_cast<uint8_t>(frame.at(i));
+    }
+    else
+    {
+        for (int i = 1; i < checksumIndex; i++)
+            sum += static_cast<uint8_t>(frame.at(i));
+    }
+    if ((m_corruptRate > 0) && std::bernoulli_distribution(m_corruptRate)(m_random))
+        sum = ~sum;
+    frame[checksumIndex] = sum;
+
+    int delay = m_latency;
+    if (m_jitter > 0)
+        delay += std::uniform_int_distribution<int>(0, m_jitter)(m_random);
+    PtyPort *port = m_port;
+    QTimer::singleShot(delay, Qt::PreciseTimer, this, [port, frame]() { port->write(frame); });
+}
+
+int DeviceEmulator::wordIndex(int32_t address)
+{
+    if ((address >= 0) && (address < FLASH_PROGRAM_WORDS))
+        return address;
+    if ((address >= FLASH_CONFIG_ADDRESS) && (address < FLASH_CONFIG_ADDRESS + FLASH_CONFIG_WORDS))
+        return FLASH_PROGRAM_WORDS + address - FLASH_CONFIG_ADDRESS;
+    return -1;
+}
+
+int DeviceEmulator::positionIndex() const
+{
+    // ADC THRESHOLDS BETWEEN POSITIONS ARE SETTINGS 7..21
+    int positionsNum = qBound(1, static_cast<int>(m_settings.at(1)), 16);
+    int index = 0;
+    while ((index < positionsNum - 1) && (m_adcValue >= static_cast<uint8_t>(m_settings.at(7 + index))))
+        index++;
+    return index;
+}
+
+void DeviceEmulator::log(const QString &text)
+{
+    if (!m_verbose)
+        return;
+    fprintf(stdout, "%s\t%s\n", qPrintable(QTime::currentTime().toString("HH:mm:ss.zzz")), qPrintable(text));
+    fflush(stdout);
+}
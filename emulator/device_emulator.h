@@ -0,0 +1,128 @@
+#ifndef DEVICE_EMULATOR_H
+#define DEVICE_EMULATOR_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <random>
+
+#include "lin_frame_decoder.h"
+#include "flash_image.h"
+
+class PtyPort;
+
+#define EMULATOR_FLASH_WORDS    (FLASH_PROGRAM_WORDS + FLASH_CONFIG_WORDS)
+#define EMULATOR_ERASED_WORD    0x3FFF
+#define EMULATOR_DEVICE_ID      0x2700  // PIC12F1822
+
+// Answers the same LIN protocol as PIC12F1822 bootloader or corrector controller.
+// Every received byte is echoed back as LIN transceiver does.
+class DeviceEmulator : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode
+    {
+        BootloaderMode,
+        ControllerMode
+    };
+
+    DeviceEmulator(PtyPort *port, Mode mode, QObject *parent = 0);
+
+    // FLASH CONTENTS BEFORE FIRST WRITE, EMPTY STRING IF OK
+    QString loadImage(const QString &fileName);
+
+    void setUserId(uint16_t userId);
+
+    void setDeviceId(uint16_t deviceId);
+
+    // DELAY FROM END OF RECEIVED FRAME TO ANSWER, MS
+    void setLatency(int latency, int jitter);
+
+    // PROBABILITY TO SEND ANSWER WITH WRONG CHECKSUM
+    void setCorruptRate(double rate) { m_corruptRate = rate; }
+
+    void setValuesPeriod(int period) { m_valuesTimer.setInterval(period); }
+
+    // COMMANDS LATER THAN WINDOW AFTER VALUES FRAME ARE IGNORED, 0 - ALWAYS LISTENS
+    void setListenWindow(int window) { m_listenWindow = window; }
+
+    void setSeed(unsigned seed) { m_random.seed(seed); }
+
+    void setVerbose(bool verbose) { m_verbose = verbose; }
+
+    void start();
+
+private slots:
+
+    void dataReceived(const QByteArray &data);
+
+    void frameReceived(const LinFrame &frame);
+
+    void sendValuesFrame();
+
+private:
+    PtyPort *m_port;
+
+    Mode m_mode;
+
+    LinFrameDecoder m_decoder;
+
+    int m_latency;
+
+    int m_jitter;
+
+    double m_corruptRate;
+
+    bool m_verbose;
+
+    std::mt19937 m_random;
+
+    uint16_t m_flash[EMULATOR_FLASH_WORDS];
+
+    QByteArray m_settings;
+
+    QByteArray m_eeprom;
+
+    QTimer m_valuesTimer;
+
+    int m_listenWindow;
+
+    QElapsedTimer m_lastValuesFrame;
+
+    int16_t m_extValues[2];
+
+    bool m_extControl;
+
+    int16_t m_readValues[2];
+
+    uint8_t m_adcValue;
+
+    int m_adcStep;
+
+    uint8_t m_errors;
+
+    uint8_t m_counter;
+
+    void bootloaderFrame(const LinFrame &frame);
+
+    void controllerFrame(const LinFrame &frame);
+
+    void answer(QByteArray frame, int checksumIndex);
+
+    void answerBootloader(uint8_t code, const QByteArray &data);
+
+    void answerController(uint8_t code, const QByteArray &data);
+
+    // -1 IF ADDRESS IS NOT IMPLEMENTED
+    static int wordIndex(int32_t address);
+
+    int positionIndex() const;
+
+    void log(const QString &text);
+};
+
+#endif // DEVICE_EMULATOR_H
@@ -0,0 +1,27 @@
+#-------------------------------------------------
+#
+# LIN device emulator on pseudo-terminal (Linux only)
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = lin_emulator
+TEMPLATE = app
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../core/core.pri)
+
+SOURCES += \
+    main.cpp \
+    pty_port.cpp \
+    device_emulator.cpp
+
+HEADERS += \
+    pty_port.h \
+    device_emulator.h
@@ -0,0 +1,84 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include <stdio.h>
+
+#include "pty_port.h"
+#include "device_emulator.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("lin_emulator");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("PIC12F1822 bootloader / corrector controller emulator on pseudo-terminal");
+    parser.addHelpOption();
+    QCommandLineOption modeOption("mode", "Emulated device: bootloader or controller.", "mode", "controller");
+    QCommandLineOption linkOption("link", "Create symlink to pseudo-terminal slave.", "path");
+    QCommandLineOption baudOption("baud", "Wire speed of transmitted bytes, 0 - no pacing.", "baud", "19200");
+    QCommandLineOption latencyOption("latency", "Answer delay, ms.", "ms", "2");
+    QCommandLineOption jitterOption("jitter", "Random extra answer delay up to, ms.", "ms", "0");
+    QCommandLineOption dropOption("drop-rate", "Probability to lose transmitted byte.", "rate", "0");
+    QCommandLineOption corruptOption("corrupt-rate", "Probability to send answer with wrong checksum.", "rate", "0");
+    QCommandLineOption periodOption("values-period", "Controller values frame period, ms.", "ms", "100");
+    QCommandLineOption listenOption("listen-window", "Controller accepts commands only this long after values frame, ms (0 - always).", "ms", "0");
+    QCommandLineOption imageOption("image", "Initial flash contents.", "hex file");
+    QCommandLineOption userIdOption("user-id", "USER ID word at 0x8000.", "word");
+    QCommandLineOption deviceIdOption("device-id", "DEVICE ID word at 0x8006.", "word");
+    QCommandLineOption seedOption("seed", "Random seed for faults.", "seed", "1");
+    QCommandLineOption verboseOption("verbose", "Print every handled command.");
+    parser.addOptions(QList<QCommandLineOption>() << modeOption << linkOption << baudOption << latencyOption << jitterOption
+                      << dropOption << corruptOption << periodOption << listenOption << imageOption << userIdOption << deviceIdOption
+                      << seedOption << verboseOption);
+    parser.process(a);
+
+    DeviceEmulator::Mode mode;
+    if (parser.value(modeOption) == "bootloader")
+        mode = DeviceEmulator::BootloaderMode;
+    else if (parser.value(modeOption) == "controller")
+        mode = DeviceEmulator::ControllerMode;
+    else
+    {
+        fprintf(stderr, "Unknown mode %s\n", qPrintable(parser.value(modeOption)));
+        return 1;
+    }
+
+    PtyPort port;
+    port.setBaudRate(parser.value(baudOption).toInt());
+    port.setDropRate(parser.value(dropOption).toDouble());
+    port.setSeed(parser.value(seedOption).toUInt());
+    if (!port.open(parser.value(linkOption)))
+    {
+        fprintf(stderr, "%s\n", qPrintable(port.errorString()));
+        return 1;
+    }
+
+    DeviceEmulator emulator(&port, mode);
+    emulator.setLatency(parser.value(latencyOption).toInt(), parser.value(jitterOption).toInt());
+    emulator.setCorruptRate(parser.value(corruptOption).toDouble());
+    emulator.setValuesPeriod(parser.value(periodOption).toInt());
+    emulator.setListenWindow(parser.value(listenOption).toInt());
+    emulator.setSeed(parser.value(seedOption).toUInt() + 1);
+    emulator.setVerbose(parser.isSet(verboseOption));
+    if (parser.isSet(imageOption))
+    {
+        QString error = emulator.loadImage(parser.value(imageOption));
+        if (!error.isEmpty())
+        {
+            fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+    }
+    if (parser.isSet(userIdOption))
+        emulator.setUserId(parser.value(userIdOption).toUShort(0, 0));
+    if (parser.isSet(deviceIdOption))
+        emulator.setDeviceId(parser.value(deviceIdOption).toUShort(0, 0));
+    emulator.start();
+
+    fprintf(stdout, "%s emulator on %s\n", qPrintable(parser.value(modeOption)),
+            qPrintable(parser.isSet(linkOption) ? parser.value(linkOption) : port.slavePath()));
+    fflush(stdout);
+
+    return a.exec();
+}
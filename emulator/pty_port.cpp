@@ -0,0 +1,158 @@
+#include "pty_port.h"
+
+#include <QSocketNotifier>
+#include <QFile>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <termios.h>
+#include <unistd.h>
+
+PtyPort::PtyPort(QObject *parent) :
+    QObject(parent),
+    m_master(-1),
+    m_slaveKeeper(-1),
+    m_notifier(0),
+    m_baudRate(19200),
+    m_dropRate(0),
+    m_txTimer(this),
+    m_txSent(0)
+{
+    m_txTimer.setInterval(1);
+    m_txTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_txTimer, &QTimer::timeout, this, &PtyPort::transmit);
+}
+
+PtyPort::~PtyPort()
+{
+    if (!m_linkName.isEmpty())
+        QFile::remove(m_linkName);
+    if (m_slaveKeeper >= 0)
+        ::close(m_slaveKeeper);
+    if (m_master >= 0)
+        ::close(m_master);
+}
+
+bool PtyPort::open(const QString &linkName)
+{
+    m_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((m_master < 0) || (grantpt(m_master) != 0) || (unlockpt(m_master) != 0))
+    {
+        m_errorString = QString("Can't create pseudo-terminal: %1").arg(strerror(errno));
+        return false;
+    }
+    m_slavePath = QString::fromLocal8Bit(ptsname(m_master));
+    fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK);
+
+    m_slaveKeeper = ::open(ptsname(m_master), O_RDWR | O_NOCTTY);
+    if (m_slaveKeeper < 0)
+    {
+        m_errorString = QString("Can't open %1: %2").arg(m_slavePath).arg(strerror(errno));
+        return false;
+    }
+    struct termios tio;
+    tcgetattr(m_slaveKeeper, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(m_slaveKeeper, TCSANOW, &tio);
+
+    if (!linkName.isEmpty())
+    {
+        QFile::remove(linkName);
+        if (!QFile::link(m_slavePath, linkName))
+        {
+            m_errorString = QString("Can't create link %1").arg(linkName);
+            return false;
+        }
+        m_linkName = linkName;
+    }
+
+    m_notifier = new QSocketNotifier(m_master, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &PtyPort::readMaster);
+    return true;
+}
+
+void PtyPort::write(const QByteArray &data)
+{
+    m_txQueue.append(data);
+    if (!m_txTimer.isActive())
+    {
+        m_txClock.start();
+        m_txSent = 0;
+        m_txTimer.start();
+        transmit();
+    }
+}
+
+void PtyPort::readMaster()
+{
+    char receivedData[256];
+    ssize_t receivedSize;
+    while ((receivedSize = ::read(m_master, receivedData, sizeof(receivedData))) > 0)
+        emit dataReceived(QByteArray(receivedData, receivedSize));
+}
+
+void PtyPort::transmit()
+{
+    // 10 BITS PER BYTE: START, 8 DATA, STOP
+    qint64 allowed = m_txQueue.size();
+    if (m_baudRate > 0)
+        allowed = m_txClock.nsecsElapsed() / 1000 * m_baudRate / 10000000 + 1 - m_txSent;
+    int size = static_cast<int>(qMin<qint64>(allowed, m_txQueue.size()));
+    if (size > 0)
+    {
+        // TAIL NOT TAKEN BY FULL PTY BUFFER STAYS QUEUED FOR NEXT TICK
+        int written = writeMaster(m_txQueue.constData(), size);
+        m_txQueue.remove(0, written);
+        m_txSent += written;
+    }
+    if (m_txQueue.isEmpty())
+        m_txTimer.stop();
+}
+
+int PtyPort::writeMaster(const char *data, int size)
+{
+    if (m_dropRate <= 0)
+        return writeAll(data, size);
+
+    // DROPPED BYTE IS TAKEN AS SENT, POSITIONS MAP PASSED BYTES BACK TO DATA
+    std::bernoulli_distribution drop(m_dropRate);
+    QByteArray passed;
+    QVector<int> positions;
+    passed.reserve(size);
+    positions.reserve(size);
+    for (int i = 0; i < size; i++)
+    {
+        if (!drop(m_random))
+        {
+            passed.append(data[i]);
+            positions.append(i);
+        }
+    }
+    int written = writeAll(passed.constData(), passed.size());
+    return (written < passed.size()) ? positions.at(written) : size;
+}
+
+int PtyPort::writeAll(const char *data, int size)
+{
+    int written = 0;
+    while (written < size)
+    {
+        ssize_t result = ::write(m_master, data + written, size - written);
+        if (result > 0)
+            written += static_cast<int>(result);
+        else if ((result < 0) && (errno == EINTR))
+            continue;
+        else if ((result == 0) || (errno == EAGAIN) || (errno == EWOULDBLOCK))
+            break;
+        else
+        {
+            // BYTES CAN'T BE DELIVERED AT ALL, THEY ARE REPORTED AND DISCARDED
+            fprintf(stderr, "Pseudo-terminal write error: %s, %d bytes lost\n", strerror(errno), size - written);
+            return size;
+        }
+    }
+    return written;
+}
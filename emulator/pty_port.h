@@ -0,0 +1,87 @@
+#ifndef PTY_PORT_H
+#define PTY_PORT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+
+#include <random>
+
+class QSocketNotifier;
+
+// Master side of Linux pseudo-terminal. Tool opens slave side (or symlink to it) as
+// usual serial port. Transmitted bytes are paced as on real wire at given baud rate.
+class PtyPort : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PtyPort(QObject *parent = 0);
+    ~PtyPort();
+
+    // LINK - OPTIONAL SYMLINK TO SLAVE DEVICE, REPLACED IF EXISTS
+    bool open(const QString &linkName = QString());
+
+    QString errorString() const { return m_errorString; }
+
+    QString slavePath() const { return m_slavePath; }
+
+    // 0 - BYTES ARE WRITTEN WITHOUT DELAY
+    void setBaudRate(int baudRate) { m_baudRate = baudRate; }
+
+    // PROBABILITY TO LOSE EVERY TRANSMITTED BYTE
+    void setDropRate(double rate) { m_dropRate = rate; }
+
+    void setSeed(unsigned seed) { m_random.seed(seed); }
+
+    // BYTES GO TO BUS AFTER ALL ALREADY QUEUED
+    void write(const QByteArray &data);
+
+signals:
+
+    void dataReceived(const QByteArray &data);
+
+private slots:
+
+    void readMaster();
+
+    void transmit();
+
+private:
+    int m_master;
+
+    // KEEPS SLAVE OPENED, ELSE MASTER READ FAILS WHILE TOOL IS DISCONNECTED
+    int m_slaveKeeper;
+
+    QString m_slavePath;
+
+    QString m_linkName;
+
+    QString m_errorString;
+
+    QSocketNotifier *m_notifier;
+
+    int m_baudRate;
+
+    double m_dropRate;
+
+    std::mt19937 m_random;
+
+    QByteArray m_txQueue;
+
+    QTimer m_txTimer;
+
+    QElapsedTimer m_txClock;
+
+    qint64 m_txSent;
+
+    // RETURNS NUMBER OF BYTES TAKEN FROM DATA, REST DID NOT FIT TO PTY BUFFER
+    int writeMaster(const char *data, int size);
+
+    int writeAll(const char *data, int size);
+};
+
+#endif // PTY_PORT_H
@@ -0,0 +1,858 @@
+#include "corrector_control.h"
+#include "ui_corrector_control.h"
+
+#include <QDateTime>
+#include <QByteArray>
+#include <QMessageBox>
+#include <QFileDialog>
+#include <QFontDatabase>
+#include <QHeaderView>
+#include <QComboBox>
+#include <QLabel>
+#include <QInputDialog>
+#include <QVBoxLayout>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QStandardPaths>
+#include <QDir>
+#include  <qmath.h>
+
+#include "hex_converter.h"
+#include "multi_flash_dialog.h"
+
+#define LIN_ERRORS_NUM  5
+QString linErrorHeaders[LIN_ERRORS_NUM] = {"PROGRAM ERROR", "CORRECTOR ERROR", "LIN ERROR", "CORRECTOR ERROR", "LIN CONNECTION "};
+QString linErrorDescriptions[LIN_ERRORS_NUM] = {"Please contact to developer", "Corrector not sent current values frame", "Lin tranciever loop broken", "Corrector not sent settings", "Lin checksum not correct!"};
+
+
+correctorControl::correctorControl(QWidget *parent) :
+    QMainWindow(parent),
+    ui(new Ui::correctorControl)
+{
+    ui->setupUi(this);
+
+    m_log = new SerialLog(ui->log, this);
+    QComboBox *logVerbosity = new QComboBox(this);
+    logVerbosity->addItems(QStringList() << "Log: messages" << "Log: raw hex dump");
+    logVerbosity->setCurrentIndex(m_log->verbosity());
+    connect(logVerbosity, SIGNAL(currentIndexChanged(int)), m_log, SLOT(setVerbosity(int)));
+    ui->mainToolBar->addWidget(logVerbosity);
+    QComboBox *logSpillMode = new QComboBox(this);
+    logSpillMode->addItems(QStringList() << "Dump file: none" << "Dump file: text" << "Dump file: binary");
+    connect(logSpillMode, SIGNAL(currentIndexChanged(int)), this, SLOT(changeLogSpillMode(int)));
+    ui->mainToolBar->addWidget(logSpillMode);
+    QAction *multiFlash = ui->mainToolBar->addAction("Multi-port flash...");
+    connect(multiFlash, &QAction::triggered, this, &correctorControl::openMultiFlash);
+    QAction *differentialWrite = ui->mainToolBar->addAction("Differential write");
+    differentialWrite->setCheckable(true);
+    differentialWrite->setToolTip("Keep snapshot of each device flash in " + m_snapshotCache.directory() + " and write only changed rows");
+    connect(differentialWrite, &QAction::toggled, this, &correctorControl::setDifferentialWrite);
+    m_verifyWrite = ui->mainToolBar->addAction("Verify write");
+    m_verifyWrite->setCheckable(true);
+    m_verifyWrite->setChecked(true);
+    m_verifyWrite->setToolTip("Read back every row right after it is written");
+    m_resume = ui->mainToolBar->addAction("Resume");
+    m_resume->setCheckable(true);
+    m_resume->setToolTip("Continue interrupted read or write from first row not confirmed on same port, image and device");
+    m_readBackSettings = ui->mainToolBar->addAction("Read back settings");
+    m_readBackSettings->setCheckable(true);
+    m_readBackSettings->setToolTip("Only changed settings chunks are sent, read whole block back to confirm");
+    m_livePositions = ui->mainToolBar->addAction("Live positions");
+    m_livePositions->setCheckable(true);
+    m_livePositions->setToolTip("Corrector positions follow sliders while dragging, one command per controller cycle");
+    QAction *recordTelemetry = ui->mainToolBar->addAction("Record values");
+    recordTelemetry->setCheckable(true);
+    recordTelemetry->setToolTip("Record every values frame to " + m_recorder.directory());
+    connect(recordTelemetry, &QAction::toggled, this, &correctorControl::setTelemetryRecording);
+    m_replayTelemetry = ui->mainToolBar->addAction("Replay values...");
+    m_replayTelemetry->setCheckable(true);
+    connect(m_replayTelemetry, &QAction::triggered, this, &correctorControl::replayTelemetry);
+    QAction *plots = ui->mainToolBar->addAction("Plots");
+
+    m_plotWindow = new QWidget(this, Qt::Window);
+    m_plotWindow->setWindowTitle("Current values");
+    QVBoxLayout *plotLayout = new QVBoxLayout(m_plotWindow);
+    QComboBox *plotWindow = new QComboBox(m_plotWindow);
+    for (int frames : {200, 1000, 5000, 20000, 100000, 1000000})
+        plotWindow->addItem(QString("Last %1 frames").arg(frames), frames);
+    plotLayout->addWidget(plotWindow);
+    m_valuesPlot = new ValuesPlot(m_plotWindow);
+    plotLayout->addWidget(m_valuesPlot, 1);
+    plotWindow->setCurrentIndex(1);
+    m_valuesPlot->setWindow(plotWindow->currentData().toInt());
+    connect(plotWindow, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            [plotWindow, this](int) { m_valuesPlot->setWindow(plotWindow->currentData().toInt()); });
+    connect(plots, &QAction::triggered, m_plotWindow, &QWidget::show);
+
+    connect(ui->connect, &QPushButton::clicked, this, &correctorControl::connectToCom);
+    connect(ui->com_reflesh, &QPushButton::clicked, this, &correctorControl::refleshComList);
+    //connect(ui->com_list, &QComboBox::currentIndexChanged, this, &correctorControl::listIndexChanged);
+    connect(ui->com_list, SIGNAL(currentIndexChanged(int)), this, SLOT(listIndexChanged(int)));
+    connect(ui->readFromFlash, SIGNAL(clicked()), this, SLOT(readFromFlash()));
+    connect(ui->writeToFlash, SIGNAL(clicked()), this, SLOT(writeToFlash()));
+
+    connect(ui->clear_log, &QPushButton::clicked, m_log, &SerialLog::clear);
+    connect(ui->openFile, &QPushButton::clicked, this, &correctorControl::openFile);
+
+    connect(ui->correctorsPositionMult, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsMult(int)), Qt::QueuedConnection);
+    connect(ui->correctorsNum, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsNum(int)), Qt::QueuedConnection);
+    connect(ui->positionsNum, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsPositionsNum(int)), Qt::QueuedConnection);
+    //connect(ui->extPositionControl, SIGNAL(toggled(bool)), this, SLOT(changeExtPositionMode(bool)), Qt::QueuedConnection);
+    connect(ui->corrector1startPosition, SIGNAL(valueChanged(int)), this, SLOT(readSettingsFromInterface()), Qt::QueuedConnection);
+    connect(ui->corrector2startPosition, SIGNAL(valueChanged(int)), this, SLOT(readSettingsFromInterface()), Qt::QueuedConnection);
+    connect(ui->corrector1address, SIGNAL(valueChanged(int)), this, SLOT(readSettingsFromInterface()), Qt::QueuedConnection);
+    connect(ui->corrector2address, SIGNAL(valueChanged(int)), this, SLOT(readSettingsFromInterface()), Qt::QueuedConnection);
+
+    connect(ui->readSettings, SIGNAL(pressed()), this, SLOT(readSettingsFromController()));
+    connect(ui->writeSettings, SIGNAL(pressed()), this, SLOT(writeSettingsToController()));
+    connect(ui->readSettingsFromEeprom, SIGNAL(pressed()), this, SLOT(readSettingsFromEeprom()));
+    connect(ui->writeSettingsToEeprom, SIGNAL(pressed()), this, SLOT(writeSettingsToEeprom()));
+    connect(ui->clearErrors, SIGNAL(pressed()), this, SLOT(clearErrors()));
+
+    connect(ui->corrector1currentPosition, SIGNAL(valueChanged(int)), this, SLOT(refleshCurrentCorrectorValues()));
+    connect(ui->corrector2currentPosition, SIGNAL(valueChanged(int)), this, SLOT(refleshCurrentCorrectorValues()));
+
+    connect(ui->corrector1currentPosition, SIGNAL(sliderReleased()), this, SLOT(readExtValuesFromInterface()));
+    connect(ui->corrector2currentPosition, SIGNAL(sliderReleased()), this, SLOT(readExtValuesFromInterface()));
+    connect(ui->extPositionControl, SIGNAL(toggled(bool)), this, SLOT(readExtValuesFromInterface()));
+    connect(ui->correctorsPositionMult, SIGNAL(valueChanged(int)), this, SLOT(readExtValuesFromInterface()));
+    connect(ui->corrector1currentPosition, SIGNAL(valueChanged(int)), this, SLOT(streamExtValues()));
+    connect(ui->corrector2currentPosition, SIGNAL(valueChanged(int)), this, SLOT(streamExtValues()));
+
+    m_tmr.setInterval(10);
+    m_tmr.setSingleShot(false);
+    //tmr.setTimerType();
+    SerialLog *log = m_log;
+    m_link = new LinLink([log](const char *data, int size) { log->rawData(data, size); }, this);
+    connect(m_link, &LinLink::frameReceived, this, &correctorControl::linFrameReceived);
+    connect(m_link, &LinLink::checksumError, this, &correctorControl::linChecksumError);
+    connect(m_link, &LinLink::rttUpdated, this, &correctorControl::linRttUpdated);
+    m_rttLabel = new QLabel(this);
+    ui->statusBar->addPermanentWidget(m_rttLabel);
+    m_flashSession = new FlashSession(m_link, this);
+    connect(m_flashSession, &FlashSession::progress, this, &correctorControl::flashProgress);
+    connect(m_flashSession, &FlashSession::rowRead, this, &correctorControl::flashRowRead);
+    m_flashSession->setJournal(&m_journal);
+    m_controller = new ControllerSession(m_link, this);
+    m_positionStreamer = new ExtPositionStreamer(m_link, this);
+    TelemetryRecorder *recorder = &m_recorder;
+    connect(m_link, &LinLink::frameReceived, this, [recorder](const LinFrame &frame) { recorder->append(frame); });
+    m_replayer = new TelemetryReplayer(this);
+    connect(m_replayer, &TelemetryReplayer::frameReplayed, this, &correctorControl::linFrameReceived);
+    connect(m_replayer, &TelemetryReplayer::finished, this, &correctorControl::telemetryReplayFinished);
+    connect(m_positionStreamer, &ExtPositionStreamer::latencyMeasured, this, &correctorControl::extPositionLatency);
+    connect(m_positionStreamer, &ExtPositionStreamer::failed, this, &correctorControl::toLog);
+
+    // PORT NAME CAN BE TYPED, E.G. PSEUDO-TERMINAL OF EMULATOR
+    ui->com_list->setEditable(true);
+    ui->com_list->setInsertPolicy(QComboBox::NoInsert);
+    refleshComList();
+
+    m_flashDataModel = new FlashDataModel(&m_flashData, this);
+    m_settingsModel = new SettingsTableModel(&m_settings, this);
+    ui->correctorPositionsTable->setModel(m_settingsModel);
+    // ONE UPDATE OF CURRENT VALUES PER DISPLAY REFRESH
+    int refreshRate = qRound(QGuiApplication::primaryScreen() ? QGuiApplication::primaryScreen()->refreshRate() : 0);
+    m_currentValues = new CurrentValuesModel(1000 / ((refreshRate > 0) ? refreshRate : 60), this);
+    ui->currentInformation->setModel(m_currentValues);
+    ui->currentInformation->horizontalHeader()->setVisible(false);
+    ui->currentInformation->verticalHeader()->setVisible(false);
+    ui->currentInformation->horizontalHeader()->setStretchLastSection(true);
+    ui->currentInformation->resizeColumnToContents(CurrentValuesModel::NameColumn);
+    ui->flashData->setModel(m_flashDataModel);
+    ui->flashData->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    ui->flashData->verticalHeader()->setVisible(false);
+    ui->flashData->horizontalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->flashData->horizontalHeader()->setDefaultSectionSize(40);
+    ui->flashData->horizontalHeader()->resizeSection(FlashDataModel::AsciiColumn, 140);
+    ui->flashData->horizontalHeader()->setStretchLastSection(true);
+
+    ui->progress->setVisible(false);
+    ui->labelCurrentProgress->setVisible(false);
+
+    QWidget* widgets_unlocked[] = { ui->writeToFlash, ui->readFromFlash  };
+    for (int i = 0; i < sizeof(widgets_unlocked)/sizeof(QWidget*); i++)
+        widgets_unlocked[i]->setEnabled(false);
+
+    loadDefaultSettings();
+    displaySettings();
+
+    readExtValuesFromInterface();
+    ui->tabCurrentControl->setEnabled(false);
+}
+
+correctorControl::~correctorControl()
+{
+    // I/O THREAD WRITES TO LOG, SO IT IS STOPPED FIRST
+    delete m_link;
+    delete ui;
+}
+
+void correctorControl::refleshComList()
+{
+    m_com_list = QSerialPortInfo::availablePorts();
+    for (int i = ui->com_list->count(); i >=0; i--)
+        ui->com_list->removeItem(i);
+    for (int i = 0; i < m_com_list.length(); i++)
+        ui->com_list->addItem(m_com_list.at(i).portName());
+}
+
+void correctorControl::connectToCom()
+{
+    QWidget* widgets_locked[] = { ui->com_list, ui->com_reflesh  };
+    QWidget* widgets_unlocked[] = { ui->writeToFlash, ui->readFromFlash, ui->tabCurrentControl };
+    if (ui->connect->text() == "Connect")   {
+        if (m_link->open(ui->com_list->currentText(), 19200))   {
+            ui->connect->setText("Disconnect");
+            toLog ("COM " + m_link->portName() + " OPENED OK");
+            m_controller->forgetSettings();
+        }
+        else
+            toLog ("COM " + m_link->portName() + " OPEN ERROR");
+    }
+    else    {
+        LinDecoderStats stats = m_link->close();
+        toLog ("COM " + m_link->portName() + " CLOSED");
+        toLog(QString("LIN: %1 bytes, %2 frames, %3 checksum errors, %4 bytes discarded, %5 resyncs")
+              .arg(stats.receivedBytes).arg(stats.frames).arg(stats.checksumErrors).arg(stats.discardedBytes).arg(stats.resyncs));
+        ui->connect->setText("Connect");
+    }
+    for (int i = 0; i < sizeof(widgets_locked)/sizeof(QWidget*); i++)
+        widgets_locked[i]->setEnabled(!m_link->isOpen());
+    for (int i = 0; i < sizeof(widgets_unlocked)/sizeof(QWidget*); i++)
+        widgets_unlocked[i]->setEnabled(m_link->isOpen());
+}
+
+void correctorControl::listIndexChanged(int index)
+{
+    if (ui->com_list->currentIndex() >= 0)
+        ui->com_list->setToolTip(m_com_list.at(index).description());
+    else
+        ui->com_list->setToolTip ("NO AVALUABLE COM!");
+}
+
+void correctorControl::toLog(const QString &text)
+{
+    m_log->message(text);
+}
+
+void correctorControl::changeLogSpillMode(int mode)
+{
+    QString dumpPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    QDir().mkpath(dumpPath);
+    QString fileName = dumpPath + ((mode == SerialLog::BinarySpill) ? "/lin_dump.bin" : "/lin_dump.txt");
+    m_log->setSpillFile(mode, fileName);
+    if (mode != SerialLog::NoSpill)
+        toLog("Received data dump to " + fileName);
+}
+
+void correctorControl::readFromFlash()
+{
+    uint16_t startAddress = ui->flashStartAddress->value();
+    uint16_t endAddress = ui->flashEndAddress->value();
+    ui->progress->setVisible(true);
+    ui->centralWidget->setEnabled(false);
+    m_flashData.clear();
+    displayFlashData();
+    setJournalFile();
+    LinReply::Error error = m_flashSession->read(startAddress, endAddress, &m_flashData);
+    ui->centralWidget->setEnabled(true);
+    if (m_journal.resumedRows() > 0)
+        toLog(QString("Read resumed, %1 rows from journal").arg(m_journal.resumedRows()));
+    if (error != LinReply::NoError)
+    {
+        showFlashError(error);
+        return;
+    }
+    ui->progress->setVisible(false);
+}
+
+void correctorControl::flashProgress(int done, int total)
+{
+    ui->progress->setText(QString::number(done) + "/" + QString::number(total) + " (" + QString::number(total ? done * 100 / total : 100) + "%)");
+}
+
+void correctorControl::flashRowRead(int32_t address)
+{
+    m_flashDataModel->updateRow(address);
+    m_flashDataModel->updateRow(address + FLASH_ROW_WORDS - 1);
+}
+
+void correctorControl::setJournalFile()
+{
+    m_journal.setFileName(m_resume->isChecked() ? FlashJournal::defaultFileName(m_link->portName()) : QString());
+}
+
+void correctorControl::showFlashError(LinReply::Error error)
+{
+    switch (error)
+    {
+    case LinReply::EchoNotReceived:
+        QMessageBox::warning(this, "LIN ERROR", "Lin can't receive transmitted bytes");
+        break;
+    case LinReply::ChecksumError:
+        QMessageBox::warning(this, "CHECKSUM ERROR", "Lin received frame with uncorrect checksum");
+        break;
+    case LinReply::BadResponse:
+        QMessageBox::warning(this, "CONTROLLER ERROR", "Controller sent frame with uncorrect struct");
+        break;
+    default:
+        QMessageBox::warning(this, "CONTROLLER ERROR", "No correct ack from controller, LIN works normally");
+        break;
+    }
+}
+
+
+
+void correctorControl::linFrameReceived(const LinFrame &frame)
+{
+    // LIVE FRAMES WOULD MIX WITH REPLAYED ONES
+    if (m_replayer->isRunning() && (sender() == m_link))
+        return;
+    if ((frame.protocol == LinFrameDecoder::ControllerProtocol) && (frame.code == VALUES_FRAME_CODE))
+        displayCurrentValues(QByteArray::fromRawData(frame.data() + 2, CURRENT_DATA_SIZE - 3));
+}
+
+void correctorControl::linChecksumError(const LinFrame &frame)
+{
+    if ((frame.protocol == LinFrameDecoder::ControllerProtocol) && (frame.code == VALUES_FRAME_CODE))
+        toLog("Received current values with uncorrect checksum");
+}
+
+void correctorControl::displayFlashData()
+{
+    m_flashDataModel->reload();
+}
+
+void correctorControl::resizeEvent(QResizeEvent *event)
+{
+    int x1 = event->oldSize().width();
+    int y1 = event->oldSize().height();
+    int x2 = event->size().width();
+    int y2 = event->size().height();
+    if ((x1 <= 0) || (y1 <= 0))
+        return;
+}
+
+void correctorControl::openFile()
+{
+    QString hexFileName = QFileDialog::getOpenFileName();
+    QFile hexFile(hexFileName);
+    if (!hexFile.open(QFile::ReadOnly))
+    {
+        QMessageBox::warning(this, "Open file error", QString("File %1 cant open").arg(hexFileName));
+        return;
+    }
+    // FILE IS PARSED DIRECTLY FROM MAPPED MEMORY, READ ONLY IF MAPPING NOT SUPPORTED
+    QByteArray hexFileData;
+    qint64 hexFileSize = hexFile.size();
+    const char *hexFileBytes = reinterpret_cast<const char*>(hexFile.map(0, hexFileSize));
+    if (hexFileBytes == 0)
+    {
+        hexFileData = hexFile.readAll();
+        hexFileBytes = hexFileData.constData();
+        hexFileSize = hexFileData.size();
+    }
+    FlashImage dataFromFile;
+    QString error = hexFileToImage(hexFileBytes, hexFileSize, &dataFromFile);
+    if (!error.isEmpty())
+    {
+        QMessageBox::warning(this, "File error", error);
+        return;
+    }
+    if (dataFromFile.isEmpty())
+    {
+        QMessageBox::warning(this, "File error", QString("File %1 is empty").arg(hexFileName));
+        return;
+    }
+    m_flashData = dataFromFile;
+    displayFlashData();
+    toLog(hexFileName + ": " + FlashWritePlan(m_flashData).summary(19200));
+}
+
+void correctorControl::writeToFlash()
+{
+    ui->progress->setVisible(true);
+    ui->centralWidget->setEnabled(false);
+    FlashWritePlan plan(m_flashData);
+    QVector<int32_t> mismatches;
+    setJournalFile();
+    LinReply::Error error = m_flashSession->applySnapshot(m_flashData, &plan);
+    if (error == LinReply::NoError)
+    {
+        toLog("Write: " + plan.summary(19200));
+        if (m_verifyWrite->isChecked())
+            error = m_flashSession->writeVerified(&m_flashData, plan, &mismatches);
+        else
+            error = m_flashSession->write(&m_flashData, plan);
+    }
+    ui->centralWidget->setEnabled(true);
+    if (m_journal.resumedRows() > 0)
+        toLog(QString("Write resumed, %1 rows confirmed by previous attempt").arg(m_journal.resumedRows()));
+    if (error != LinReply::NoError)
+    {
+        showFlashError(error);
+        return;
+    }
+    if (!mismatches.isEmpty())
+    {
+        QMessageBox::warning(this, "VERIFY ERROR", QString("%1 rows differ from image after %2 rewrites, first at %3")
+                             .arg(mismatches.size()).arg(FLASH_VERIFY_RETRIES).arg(mismatches.first(), 4, 16, QChar('0')));
+        return;
+    }
+    ui->progress->setVisible(false);
+}
+
+void correctorControl::linRttUpdated(const LinRttStats &stats)
+{
+    m_rttLabel->setText(QString("%1: %2\u00B1%3 ms, timeout %4 ms").arg(stats.name).arg(stats.srtt, 0, 'f', 1)
+                        .arg(stats.rttvar, 0, 'f', 1).arg(stats.timeout));
+    QStringList lines;
+    foreach (const LinRttStats &command, m_link->rttStats())
+        lines.append(QString("%1: %2\u00B1%3 ms, timeout %4 ms, %5 samples").arg(command.name).arg(command.srtt, 0, 'f', 1)
+                     .arg(command.rttvar, 0, 'f', 1).arg(command.timeout).arg(command.samples));
+    m_rttLabel->setToolTip(lines.join("\n"));
+}
+
+void correctorControl::setDifferentialWrite(bool enabled)
+{
+    m_flashSession->setSnapshotCache(enabled ? &m_snapshotCache : 0);
+}
+
+void correctorControl::openMultiFlash()
+{
+    if (m_flashData.isEmpty())
+    {
+        QMessageBox::warning(this, "NO IMAGE", "Open hex file first");
+        return;
+    }
+    MultiFlashDialog dialog(m_flashData, 19200, m_snapshotCache.directory(), this);
+    dialog.exec();
+}
+
+void correctorControl::changeCorrectorsMult(int mult)
+{
+    ui->corrector1startPosition->setSingleStep(mult);
+    ui->corrector2startPosition->setSingleStep(mult);
+    ui->corrector1startPosition->setMaximum(mult * 255);
+    ui->corrector2startPosition->setMaximum(mult * 255);
+    m_settingsModel->setPositionMult(mult);
+    readSettingsFromInterface();
+}
+
+void correctorControl::changeCorrectorsNum(int num)
+{
+    m_settingsModel->setCorrectorsNum(num);
+}
+
+void correctorControl::changeCorrectorsPositionsNum(int num)
+{
+    m_settingsModel->setPositionsNum(num);
+}
+
+void correctorControl::changeExtPositionMode(bool isExtPositionChecked)
+{
+    ui->corrector1currentPosition->setEnabled(isExtPositionChecked);
+    ui->corrector2currentPosition->setEnabled(isExtPositionChecked);
+}
+
+void correctorControl::displaySettings()
+{
+    disconnect(ui->correctorsPositionMult, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsMult(int)));
+    disconnect(ui->correctorsNum, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsNum(int)));
+    disconnect(ui->positionsNum, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsPositionsNum(int)));
+    disconnect(ui->extPositionControl, SIGNAL(toggled(bool)), this, SLOT(changeExtPositionMode(bool)));
+    disconnect(ui->corrector1startPosition, SIGNAL(valueChanged(int)), this, SLOT(readSettingsFromInterface()));
+    disconnect(ui->corrector2startPosition, SIGNAL(valueChanged(int)), this, SLOT(readSettingsFromInterface()));
+
+    ui->correctorsNum->setValue(m_settings.correctorsNum);
+    ui->positionsNum->setValue(m_settings.positionsNum);
+    ui->correctorsPositionMult->setValue(m_settings.positionMult);
+    ui->corrector1address->setValue(m_settings.correctorAddresses[0]);
+    ui->corrector2address->setValue(m_settings.correctorAddresses[1]);
+    ui->corrector1startPosition->setValue(m_settings.startPositions[0] * ui->correctorsPositionMult->value());
+    ui->corrector2startPosition->setValue(m_settings.startPositions[1] * ui->correctorsPositionMult->value());
+
+    m_settingsModel->reload();
+
+    connect(ui->correctorsPositionMult, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsMult(int)), Qt::QueuedConnection);
+    connect(ui->correctorsNum, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsNum(int)), Qt::QueuedConnection);
+    connect(ui->positionsNum, SIGNAL(valueChanged(int)), this, SLOT(changeCorrectorsPositionsNum(int)), Qt::QueuedConnection);
+    connect(ui->extPositionControl, SIGNAL(toggled(bool)), this, SLOT(changeExtPositionMode(bool)), Qt::QueuedConnection);
+    connect(ui->corrector1startPosition, SIGNAL(valueChanged(int)), this, SLOT(readSettingsFromInterface()), Qt::QueuedConnection);
+    connect(ui->corrector2startPosition, SIGNAL(valueChanged(int)), this, SLOT(readSettingsFromInterface()), Qt::QueuedConnection);
+}
+
+void correctorControl::readSettingsFromInterface()
+{
+    // TABLE AND NUMBERS OF POSITIONS AND CORRECTORS ARE KEPT BY m_settingsModel
+    m_settings.correctorAddresses[0] = ui->corrector1address->value();
+    m_settings.correctorAddresses[1] = ui->corrector2address->value();
+    m_settings.startPositions[0] = calcDiv(ui->corrector1startPosition->value(), ui->correctorsPositionMult->value());
+    m_settings.startPositions[1] = calcDiv(ui->corrector2startPosition->value(), ui->correctorsPositionMult->value());
+}
+
+void correctorControl::loadDefaultSettings()
+{
+    m_settings = ControllerSettings::fromBytes(defaultSettings());
+}
+
+int correctorControl::calcDiv(int num, int div)
+{
+    int divident = qRound(((qreal)num) / ((qreal)div));
+    return divident;
+}
+
+void correctorControl::displayCurrentValues(const QByteArray &packet)
+{
+//    uint8_t temperature;
+//    uint8_t adcPositionValue;
+//    uint8_t positionIndex;
+//    uint16_t rdCorrectorValues[2];
+//    uint16_t wrCorrectorValues[2];
+//    //uint16_t extCorrectorValues[2];
+//    currentFlags_t flags;
+//    internalErrorFlags_t internalErrors;
+//    motorErrorFlags_t motorErrors[2];
+//    uint8_t counter;
+//    uint8_t displayed_error;
+
+    m_valuesPlot->appendValues(packet.constData());
+    m_currentValues->setValues(packet.constData());
+}
+
+void correctorControl::readSettingsFromController()
+{
+    ui->labelCurrentProgress->setVisible(true);
+    ui->centralWidget->setEnabled(false);
+
+    QByteArray readSettingsFrame = commandFrame(READ_SETTINGS_CODE);
+
+    QByteArray ackFrame = sendFrameAndWaitAck(readSettingsCommand, readSettingsFrame);
+
+    if (ackFrame.size() != SETTINGS_DATA_SIZE)
+        ackFrame = QByteArray(1, 0);
+    if (ackFrame.size() == 1)
+    {
+        if ((ackFrame.at(0) >= LIN_ERRORS_NUM) || (ackFrame.at(0) < 0))
+            ackFrame[0] = 0;
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, linErrorHeaders[ackFrame.at(0)], linErrorDescriptions[ackFrame.at(0)]);
+        return;
+    }
+
+    QByteArray settingsValues = ackFrame.mid(2, SETTINGS_DATA_SIZE - 3);
+
+    QString errorsInSettings = checkSettings(settingsValues);
+    if (!errorsInSettings.isEmpty())
+    {
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, "RECEIVED SETTINGS ERROR", errorsInSettings);
+        return;
+    }
+
+    m_settings = ControllerSettings::fromBytes(settingsValues);
+    displaySettings();
+    QMessageBox::information(this, "SETTINGS RECEIVED", "Received settings OK!");
+
+    ui->labelCurrentProgress->setVisible(false);
+    ui->centralWidget->setEnabled(true);
+}
+
+void correctorControl::writeSettingsToController()
+{
+    ui->labelCurrentProgress->setVisible(true);
+    ui->centralWidget->setEnabled(false);
+
+    ui->labelCurrentProgress->setText("Waiting curValues frame...");
+    QMetaObject::Connection sentConnection = connect(m_controller, &ControllerSession::sent, ui->labelCurrentProgress,
+                                                     [this]() { ui->labelCurrentProgress->setText("Waiting settings acks..."); });
+    int sentChunks = 0;
+    QString error = m_controller->writeChangedSettings(m_settings.toBytes(), m_readBackSettings->isChecked(), &sentChunks);
+    disconnect(sentConnection);
+    toLog(QString("Settings: %1 of %2 chunks sent").arg(sentChunks).arg(SETTINGS_CHUNKS_NUM));
+
+    ui->labelCurrentProgress->setVisible(false);
+    ui->centralWidget->setEnabled(true);
+    if (m_controller->lastError() != LinReply::NoError)
+    {
+        int code = (m_controller->lastError() == LinReply::BadResponse) ? LinReply::NoResponse : m_controller->lastError();
+        if ((code >= LIN_ERRORS_NUM) || (code < 0))
+            code = 0;
+        QMessageBox::warning(this, linErrorHeaders[code], linErrorDescriptions[code]);
+        return;
+    }
+    if (!error.isEmpty())
+    {
+        QMessageBox::warning(this, "TRANSMISSION SETTINGS ERROR", error);
+        return;
+    }
+
+    QMessageBox::information(this, "SETTINGS SENDED", "Sending settings OK!");
+}
+
+void correctorControl::readSettingsFromEeprom()
+{
+    ui->labelCurrentProgress->setVisible(true);
+    ui->centralWidget->setEnabled(false);
+
+    QByteArray readFromEepromFrame = commandFrame(EEPROM_READ_CODE);
+
+    QByteArray ackFrame = sendFrameAndWaitAck(eepromReadCommand, readFromEepromFrame);
+
+    if (ackFrame.size() != ACK_FRAME_SIZE)
+        ackFrame = QByteArray(1, 0);
+    if (ackFrame.size() == 1)
+    {
+        if ((ackFrame.at(0) >= LIN_ERRORS_NUM) || (ackFrame.at(0) < 0))
+            ackFrame[0] = 0;
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, linErrorHeaders[ackFrame.at(0)], linErrorDescriptions[ackFrame.at(0)]);
+        return;
+    }
+
+    if (ackFrame.at(2) != 0)
+    {
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, "READ FROM EEPROM ERROR", QString("Controller sent error code %1").arg(static_cast<uint8_t>(ackFrame.at(2))));
+        return;
+    }
+
+    ui->labelCurrentProgress->setVisible(false);
+    ui->centralWidget->setEnabled(true);
+}
+
+void correctorControl::writeSettingsToEeprom()
+{
+    ui->labelCurrentProgress->setVisible(true);
+    ui->centralWidget->setEnabled(false);
+
+    QByteArray writeToEepromFrame = commandFrame(EEPROM_WRITE_CODE);
+
+    QByteArray ackFrame = sendFrameAndWaitAck(eepromWriteCommand, writeToEepromFrame);
+
+    if (ackFrame.size() != ACK_FRAME_SIZE)
+        ackFrame = QByteArray(1, 0);
+    if (ackFrame.size() == 1)
+    {
+        if ((ackFrame.at(0) >= LIN_ERRORS_NUM) || (ackFrame.at(0) < 0))
+            ackFrame[0] = 0;
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, linErrorHeaders[ackFrame.at(0)], linErrorDescriptions[ackFrame.at(0)]);
+        return;
+    }
+
+    if (ackFrame.at(2) != 0)
+    {
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, "WRITE TO EEPROM ERROR", QString("Controller sent error code %1").arg(static_cast<uint8_t>(ackFrame.at(2))));
+        return;
+    }
+
+    ui->labelCurrentProgress->setVisible(false);
+    ui->centralWidget->setEnabled(true);
+}
+
+void correctorControl::clearErrors()
+{
+    ui->labelCurrentProgress->setVisible(true);
+    ui->centralWidget->setEnabled(false);
+
+    QByteArray clearErrorsFrame = commandFrame(CLEAR_ERRORS_CODE);
+
+    QByteArray ackFrame = sendFrameAndWaitAck(clearErrorsCommand, clearErrorsFrame);
+
+    if (ackFrame.size() != ACK_FRAME_SIZE)
+        ackFrame = QByteArray(1, 0);
+    if (ackFrame.size() == 1)
+    {
+        if ((ackFrame.at(0) >= LIN_ERRORS_NUM) || (ackFrame.at(0) < 0))
+            ackFrame[0] = 0;
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, linErrorHeaders[ackFrame.at(0)], linErrorDescriptions[ackFrame.at(0)]);
+        return;
+    }
+
+    if (ackFrame.at(2) != 0)
+    {
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, "CLEAR ERRORS COMMAND ERROR", QString("Controller sent error code %1").arg(static_cast<uint8_t>(ackFrame.at(2))));
+        return;
+    }
+
+    ui->labelCurrentProgress->setVisible(false);
+    ui->centralWidget->setEnabled(true);
+}
+
+void correctorControl::refleshCurrentCorrectorValues()
+{
+    if (!ui->extPositionControl->isChecked())
+    {
+        ui->corrector1currentPosition->setEnabled(false);
+        ui->corrector2currentPosition->setEnabled(false);
+    }
+
+    int16_t correctorValues[2];
+    correctorValues[0] = ui->correctorsPositionMult->value() * ui->corrector1currentPosition->value();
+    correctorValues[1] = ui->correctorsPositionMult->value() * ui->corrector2currentPosition->value();
+
+    ui->corrector1positionLabel->setText("Corrector 1: " + QString::number(correctorValues[0]));
+    ui->corrector2positionLabel->setText("Corrector 2: " + QString::number(correctorValues[1]));
+}
+
+void correctorControl::readExtValuesFromInterface()
+{
+    if (!ui->extPositionControl->isChecked())
+    {
+        ui->corrector1currentPosition->setEnabled(false);
+        ui->corrector2currentPosition->setEnabled(false);
+    }
+
+    int16_t correctorValues[2];
+    correctorValues[0] = ui->correctorsPositionMult->value() * ui->corrector1currentPosition->value();
+    correctorValues[1] = ui->correctorsPositionMult->value() * ui->corrector2currentPosition->value();
+
+    ui->corrector1positionLabel->setText("Corrector 1: " + QString::number(correctorValues[0]));
+    ui->corrector2positionLabel->setText("Corrector 2: " + QString::number(correctorValues[1]));
+
+    if (!m_link->isOpen())
+        return;
+
+    if (m_livePositions->isChecked())
+    {
+        m_positionStreamer->setTarget(correctorValues[0], correctorValues[1], ui->extPositionControl->isChecked());
+        return;
+    }
+
+    QByteArray sendCurrentValuesFrame = extPositionsFrame(correctorValues[0], correctorValues[1], ui->extPositionControl->isChecked());
+
+    ui->labelCurrentProgress->setVisible(true);
+    ui->centralWidget->setEnabled(false);
+
+    QByteArray ackFrame = sendFrameAndWaitAck(extPositionsCommand, sendCurrentValuesFrame);
+
+    if (ackFrame.size() != ACK_FRAME_SIZE)
+        ackFrame = QByteArray(1, 0);
+    if (ackFrame.size() == 1)
+    {
+        if ((ackFrame.at(0) >= LIN_ERRORS_NUM) || (ackFrame.at(0) < 0))
+            ackFrame[0] = 0;
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, linErrorHeaders[ackFrame.at(0)], linErrorDescriptions[ackFrame.at(0)]);
+        return;
+    }
+
+    if (ackFrame.at(2) != 0)
+    {
+        ui->labelCurrentProgress->setVisible(false);
+        ui->centralWidget->setEnabled(true);
+        QMessageBox::warning(this, "SEND EXT POSITIONS COMMAND ERROR", QString("Controller sent error code %1").arg(static_cast<uint8_t>(ackFrame.at(2))));
+        return;
+    }
+
+    ui->labelCurrentProgress->setVisible(false);
+    ui->centralWidget->setEnabled(true);
+}
+
+void correctorControl::streamExtValues()
+{
+    // RELEASE OF SLIDER IS HANDLED BY readExtValuesFromInterface()
+    if (!m_livePositions->isChecked() || !ui->extPositionControl->isChecked() || !m_link->isOpen())
+        return;
+    m_positionStreamer->setTarget(ui->correctorsPositionMult->value() * ui->corrector1currentPosition->value(),
+                                  ui->correctorsPositionMult->value() * ui->corrector2currentPosition->value(), true);
+}
+
+void correctorControl::extPositionLatency(int latency)
+{
+    ui->statusBar->showMessage(QString("Positions applied in %1 ms, %2 intermediate values skipped")
+                               .arg(latency).arg(m_positionStreamer->coalesced()), 2000);
+}
+
+void correctorControl::setTelemetryRecording(bool enabled)
+{
+    if (!enabled)
+    {
+        if (m_recorder.isRecording())
+            toLog(QString("Telemetry: %1 values frames recorded to %2").arg(m_recorder.records()).arg(m_recorder.recordingDirectory()));
+        m_recorder.stop();
+        return;
+    }
+    if (!m_recorder.start())
+        QMessageBox::warning(this, "FILE ERROR", "Can't create telemetry recording in " + m_recorder.directory());
+}
+
+void correctorControl::replayTelemetry(bool enabled)
+{
+    if (!enabled)
+    {
+        m_replayer->stop();
+        return;
+    }
+    m_replayTelemetry->setChecked(false);
+    QString directory = QFileDialog::getExistingDirectory(this, "Open recording", m_recorder.directory());
+    if (directory.isEmpty())
+        return;
+    if (!m_replayer->open(directory))
+    {
+        QMessageBox::warning(this, "FILE ERROR", "No values frames recorded in " + directory);
+        return;
+    }
+    bool ok;
+    QStringList speeds = QStringList() << "1x" << "10x" << "As fast as possible";
+    QString speed = QInputDialog::getItem(this, "Replay values", "Speed", speeds, 0, false, &ok);
+    if (!ok)
+        return;
+    m_replayTelemetry->setChecked(true);
+    toLog(QString("Telemetry: replaying %1 values frames").arg(m_replayer->reader().count()));
+    m_replayer->start((speed == speeds.at(0)) ? 1.0 : ((speed == speeds.at(1)) ? 10.0 : 0.0));
+}
+
+void correctorControl::telemetryReplayFinished()
+{
+    m_replayTelemetry->setChecked(false);
+    toLog("Telemetry: replay finished");
+}
+
+QByteArray correctorControl::sendFrameAndWaitAck(const LinCommand &command, QByteArray frameToSend, QString waitState)
+{
+    if (frameToSend.size() != COMMAND_FRAME_SIZE)
+        return QByteArray(1, 0);
+
+    ui->labelCurrentProgress->setText("Waiting curValues frame...");
+    QMetaObject::Connection sentConnection = connect(m_controller, &ControllerSession::sent, ui->labelCurrentProgress,
+                                                     [this, waitState]() { ui->labelCurrentProgress->setText(waitState); });
+    QByteArray answer;
+    LinReply::Error error = m_controller->transfer(command, frameToSend, &answer);
+    disconnect(sentConnection);
+
+    QByteArray result;
+    switch (error)
+    {
+    case LinReply::NoError:
+        result = answer;
+        break;
+    case LinReply::NoValuesFrame:
+    case LinReply::EchoNotReceived:
+    case LinReply::NoResponse:
+    case LinReply::ChecksumError:
+        result = QByteArray(1, error);
+        break;
+    case LinReply::BadResponse:
+        result = QByteArray(1, LinReply::NoResponse);
+        break;
+    default:
+        result = QByteArray(1, 0);
+        break;
+    }
+    return result;
+}
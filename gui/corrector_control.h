@@ -0,0 +1,176 @@
+#ifndef CORRECTOR_CONTROL_H
+#define CORRECTOR_CONTROL_H
+
+#include <QMainWindow>
+
+#include <QtSerialPort/qserialport.h>
+#include <QtSerialPort/qserialportinfo.h>
+
+#include <QTimer>
+
+#include "flash_image.h"
+#include "flash_data_model.h"
+#include "current_values_model.h"
+#include "settings_table_model.h"
+#include "lin_link.h"
+#include "flash_session.h"
+#include "controller_session.h"
+#include "ext_position_streamer.h"
+#include "telemetry_replayer.h"
+#include "serial_log.h"
+#include "values_plot.h"
+
+namespace Ui {
+class correctorControl;
+}
+
+class QLabel;
+
+class correctorControl : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    explicit correctorControl(QWidget *parent = 0);
+    ~correctorControl();
+
+private slots:
+
+    void refleshComList();
+
+    void connectToCom();
+
+    void listIndexChanged(int index);
+
+    void toLog(const QString& text);
+
+    void changeLogSpillMode(int mode);
+
+    void readFromFlash();
+
+    void linFrameReceived(const LinFrame &frame);
+
+    void linChecksumError(const LinFrame &frame);
+
+    void linRttUpdated(const LinRttStats &stats);
+
+    void flashProgress(int done, int total);
+
+    void flashRowRead(int32_t address);
+
+    void openFile();
+
+    void writeToFlash();
+
+    void openMultiFlash();
+
+    void setDifferentialWrite(bool enabled);
+
+    void changeCorrectorsMult(int mult);
+
+    void changeCorrectorsNum(int num);
+
+    void changeCorrectorsPositionsNum(int num);
+
+    void changeExtPositionMode(bool isExtPositionChecked);
+
+    void readSettingsFromInterface();
+
+    void readSettingsFromController();
+
+    void writeSettingsToController();
+
+    void readSettingsFromEeprom();
+
+    void writeSettingsToEeprom();
+
+    void refleshCurrentCorrectorValues();
+
+    void readExtValuesFromInterface();
+
+    void streamExtValues();
+
+    void extPositionLatency(int latency);
+
+    void setTelemetryRecording(bool enabled);
+
+    void replayTelemetry(bool enabled);
+
+    void telemetryReplayFinished();
+
+    void clearErrors();
+
+protected:
+
+    virtual void resizeEvent(QResizeEvent *);
+
+private:
+    Ui::correctorControl *ui;
+
+    QList<QSerialPortInfo> m_com_list;
+
+    SerialLog *m_log;
+
+    LinLink *m_link;
+
+    FlashSession *m_flashSession;
+
+    DeviceSnapshotCache m_snapshotCache;
+
+    FlashJournal m_journal;
+
+    QAction *m_verifyWrite;
+
+    QAction *m_resume;
+
+    QAction *m_readBackSettings;
+
+    QAction *m_livePositions;
+
+    ExtPositionStreamer *m_positionStreamer;
+
+    QAction *m_replayTelemetry;
+
+    TelemetryRecorder m_recorder;
+
+    TelemetryReplayer *m_replayer;
+
+    QWidget *m_plotWindow;
+
+    ValuesPlot *m_valuesPlot;
+
+    QLabel *m_rttLabel;
+
+    ControllerSession *m_controller;
+
+    QTimer m_tmr;
+
+    FlashImage m_flashData;
+
+    FlashDataModel *m_flashDataModel;
+
+    CurrentValuesModel *m_currentValues;
+
+    void showFlashError(LinReply::Error error);
+
+    // JOURNAL OF PORT ONLY WHEN RESUME IS CHECKED
+    void setJournalFile();
+
+    void displayFlashData();
+
+    ControllerSettings m_settings;
+
+    SettingsTableModel *m_settingsModel;
+
+    void displaySettings();
+
+    void loadDefaultSettings();
+
+    int calcDiv(int num, int div);
+
+    void displayCurrentValues(const QByteArray &packet);
+
+    QByteArray sendFrameAndWaitAck(const LinCommand &command, QByteArray frameToSend, QString waitState = QString("Waiting ack"));
+};
+
+#endif // CORRECTOR_CONTROL_H
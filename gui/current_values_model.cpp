@@ -0,0 +1,176 @@
+#include "current_values_model.h"
+
+#include <QTime>
+
+#include <string.h>
+
+namespace {
+
+struct FieldLayout
+{
+    const char *name;
+    int offset;
+    int size;
+};
+
+// SAME ORDER AS CurrentValuesModel::Row, TIME IS NOT PART OF FRAME
+const FieldLayout fieldLayouts[CurrentValuesModel::RowsNum] = {
+    { "Time", 0, 0 },
+    { "Temperature", 0, 1 },
+    { "Adc value", 1, 1 },
+    { "Position index", 2, 1 },
+    { "Real corrector 1 value", 3, 2 },
+    { "Real corrector 2 value", 5, 2 },
+    { "Written corrector 1 value", 7, 2 },
+    { "Written corrector 2 value", 9, 2 },
+    { "Flags", 11, 1 },
+    { "Internal errors", 12, 1 },
+    { "Motor 0 errors", 13, 1 },
+    { "Motor 1 errors", 14, 1 },
+    { "Displayed error", 15, 1 }
+};
+
+const char *motorErrorNames[] = {
+    "LIN_TXRX_INIT", "NO_ACK_INIT", "CHECKSUM_ERROR", "LIN_TXRX_PROCESSING",
+    "NO_ACK_PROCESSING", "BAD_CONNECTION_PROCESSING", "LIN_TXRX_SET"
+};
+
+struct FlagTexts
+{
+    QString flags[256];
+    QString internalErrors[256];
+    QString motorErrors[256];
+
+    FlagTexts();
+};
+
+FlagTexts::FlagTexts()
+{
+    for (int value = 0; value < 256; value++)
+    {
+        QString prefix = QString::number(value) + ": ";
+
+        flags[value] = prefix + ((value & 0x01) ? "C1 INIT OK " : "C1 NOT INITED ");
+        flags[value] += (value & 0x02) ? "C2 INIT OK " : "C2 NOT INITED ";
+        if (value & 0x08)
+            flags[value] += "EXT VALUES ";
+
+        internalErrors[value] = prefix;
+        if (value == 0)
+            internalErrors[value] += "NONE";
+        if ((value & 0x01) && ((value & 0x02) == 0))
+            internalErrors[value] += "SETTINGS ERROR ";
+        if (value & 0x02)
+            internalErrors[value] += "SETTINGS EMPTY ";
+        if (value & 0x04)
+            internalErrors[value] += "ADC VALUE UNCORRECT ";
+        if (value & 0x08)
+            internalErrors[value] += "LIN ERROR ";
+
+        motorErrors[value] = prefix;
+        if (value == 0)
+            motorErrors[value] += "NONE";
+        for (int bit = 0; bit < 7; bit++)
+            if (value & (1 << bit))
+                motorErrors[value] += QString(motorErrorNames[bit]) + " ";
+    }
+}
+
+const FlagTexts &flagTexts()
+{
+    static const FlagTexts texts;
+    return texts;
+}
+
+int16_t wordAt(const char *data, int offset)
+{
+    return static_cast<int16_t>((data[offset + 1] << 8) | (data[offset] & 0xFF));
+}
+
+}
+
+CurrentValuesModel::CurrentValuesModel(int refreshInterval, QObject *parent) :
+    QAbstractTableModel(parent),
+    m_hasShown(false)
+{
+    memset(m_latest, 0, sizeof(m_latest));
+    memset(m_shown, 0, sizeof(m_shown));
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(refreshInterval);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &CurrentValuesModel::refresh);
+}
+
+int CurrentValuesModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : RowsNum;
+}
+
+int CurrentValuesModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnsNum;
+}
+
+QVariant CurrentValuesModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole))
+        return QVariant();
+    if (index.column() == NameColumn)
+        return QString(fieldLayouts[index.row()].name);
+    return m_text[index.row()];
+}
+
+void CurrentValuesModel::setValues(const char *data)
+{
+    memcpy(m_latest, data, CURRENT_VALUES_SIZE);
+    if (!m_refreshTimer.isActive())
+        m_refreshTimer.start();
+}
+
+void CurrentValuesModel::clear()
+{
+    m_refreshTimer.stop();
+    m_hasShown = false;
+    for (int row = 0; row < RowsNum; row++)
+        m_text[row].clear();
+    emit dataChanged(index(0, ValueColumn), index(RowsNum - 1, ValueColumn));
+}
+
+void CurrentValuesModel::refresh()
+{
+    m_text[TimeRow] = QTime::currentTime().toString("hh:mm:ss.zzz");
+    emit dataChanged(index(TimeRow, ValueColumn), index(TimeRow, ValueColumn));
+
+    for (int row = TimeRow + 1; row < RowsNum; row++)
+    {
+        const FieldLayout &field = fieldLayouts[row];
+        if (m_hasShown && (memcmp(m_shown + field.offset, m_latest + field.offset, field.size) == 0))
+            continue;
+        memcpy(m_shown + field.offset, m_latest + field.offset, field.size);
+        m_text[row] = valueText(row);
+        emit dataChanged(index(row, ValueColumn), index(row, ValueColumn));
+    }
+    m_hasShown = true;
+}
+
+QString CurrentValuesModel::valueText(int row) const
+{
+    const FieldLayout &field = fieldLayouts[row];
+    uint8_t byte = static_cast<uint8_t>(m_shown[field.offset]);
+    switch (row)
+    {
+    case ReadCorrector1Row:
+    case ReadCorrector2Row:
+    case WrittenCorrector1Row:
+    case WrittenCorrector2Row:
+        return QString::number(wordAt(m_shown, field.offset));
+    case FlagsRow:
+        return flagTexts().flags[byte];
+    case InternalErrorsRow:
+        return flagTexts().internalErrors[byte];
+    case Motor0ErrorsRow:
+    case Motor1ErrorsRow:
+        return flagTexts().motorErrors[byte];
+    default:
+        return QString::number(byte);
+    }
+}
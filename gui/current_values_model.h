@@ -0,0 +1,77 @@
+#ifndef CURRENT_VALUES_MODEL_H
+#define CURRENT_VALUES_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QString>
+#include <QTimer>
+
+#include "lin_frame_decoder.h"
+
+#define CURRENT_VALUES_SIZE (CURRENT_DATA_SIZE - 3)
+
+// Table of decoded values frame, one row per field. Frames only replace latest data; once
+// per display refresh the fields whose bytes differ from shown ones are formatted and
+// reported by dataChanged, the rest of table is not touched. Flag bytes are decoded by
+// tables built once for all 256 values.
+class CurrentValuesModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Row
+    {
+        TimeRow,
+        TemperatureRow,
+        AdcValueRow,
+        PositionIndexRow,
+        ReadCorrector1Row,
+        ReadCorrector2Row,
+        WrittenCorrector1Row,
+        WrittenCorrector2Row,
+        FlagsRow,
+        InternalErrorsRow,
+        Motor0ErrorsRow,
+        Motor1ErrorsRow,
+        DisplayedErrorRow,
+        RowsNum
+    };
+
+    enum Column
+    {
+        NameColumn,
+        ValueColumn,
+        ColumnsNum
+    };
+
+    explicit CurrentValuesModel(int refreshInterval, QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+    // VALUES FRAME DATA WITHOUT SYNC, CODE AND CHECKSUM
+    void setValues(const char *data);
+
+    void clear();
+
+private slots:
+
+    void refresh();
+
+private:
+    char m_latest[CURRENT_VALUES_SIZE];
+
+    char m_shown[CURRENT_VALUES_SIZE];
+
+    bool m_hasShown;
+
+    QString m_text[RowsNum];
+
+    QTimer m_refreshTimer;
+
+    QString valueText(int row) const;
+};
+
+#endif // CURRENT_VALUES_MODEL_H
@@ -0,0 +1,158 @@
+#include "flash_data_model.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+namespace {
+
+struct ConfigWordName
+{
+    int32_t address;
+    const char *name;
+};
+
+const ConfigWordName configWordNames[] = {
+    { 0x8000, "USER ID 0" },
+    { 0x8001, "USER ID 1" },
+    { 0x8002, "USER ID 2" },
+    { 0x8003, "USER ID 3" },
+    { 0x8006, "DEVICE ID" },
+    { 0x8007, "CONFIGURATION WORD 1" },
+    { 0x8008, "CONFIGURATION WORD 2" }
+};
+
+const int CONFIG_WORD_NAMES_NUM = sizeof(configWordNames) / sizeof(ConfigWordName);
+
+const char *configWordName(int32_t address)
+{
+    for (int i = 0; i < CONFIG_WORD_NAMES_NUM; i++)
+        if (configWordNames[i].address == address)
+            return configWordNames[i].name;
+    return 0;
+}
+
+}
+
+FlashDataModel::FlashDataModel(const FlashImage *image, QObject *parent) :
+    QAbstractTableModel(parent),
+    m_image(image)
+{
+    reload();
+}
+
+int FlashDataModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+int FlashDataModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return ColumnsNum;
+}
+
+QVariant FlashDataModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() >= m_rows.size()))
+        return QVariant();
+    int32_t rowAddress = m_rows.at(index.row());
+    int column = index.column();
+
+    if (role == Qt::ToolTipRole)
+    {
+        if ((column >= FirstWordColumn) && (column < AsciiColumn))
+        {
+            const char *name = configWordName(rowAddress + column - FirstWordColumn);
+            if (name != 0)
+                return QString(name);
+        }
+        return QVariant();
+    }
+
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (column == AddressColumn)
+        return QString("%1").arg(rowAddress, 4, 16, QChar('0'));
+    if ((column >= FirstWordColumn) && (column < AsciiColumn))
+        return QString("%1").arg(m_image->word(rowAddress + column - FirstWordColumn), 4, 16, QChar('0'));
+    if (column == AsciiColumn)
+        return asciiText(rowAddress);
+    if (column == DecodeColumn)
+        return configText(rowAddress);
+    return QVariant();
+}
+
+QVariant FlashDataModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((role != Qt::DisplayRole) || (orientation != Qt::Horizontal))
+        return QVariant();
+    if (section == AddressColumn)
+        return QString("Address");
+    if ((section >= FirstWordColumn) && (section < AsciiColumn))
+        return QString::number(section - FirstWordColumn, 16);
+    if (section == AsciiColumn)
+        return QString("ASCII");
+    if (section == DecodeColumn)
+        return QString("Config");
+    return QVariant();
+}
+
+void FlashDataModel::reload()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_rows.reserve(m_image->rowsCount());
+    for (FlashImage::Row row : *m_image)
+        m_rows.append(row.address);
+    endResetModel();
+}
+
+void FlashDataModel::updateRow(int32_t address)
+{
+    if (!m_image->isRowPresent(address))
+        return;
+    int32_t rowAddress = address - address % FLASH_ROW_WORDS;
+    QVector<int32_t>::iterator position = std::lower_bound(m_rows.begin(), m_rows.end(), rowAddress);
+    int row = position - m_rows.begin();
+    if ((position == m_rows.end()) || (*position != rowAddress))
+    {
+        beginInsertRows(QModelIndex(), row, row);
+        m_rows.insert(row, rowAddress);
+        endInsertRows();
+    }
+    else
+        emit dataChanged(index(row, 0), index(row, ColumnsNum - 1));
+}
+
+QString FlashDataModel::asciiText(int32_t rowAddress) const
+{
+    // LOW BYTES OF WORDS - RETLW TABLES WITH TEXT ARE READABLE
+    const char *data = m_image->rowData(rowAddress);
+    QString text(FLASH_ROW_WORDS, QChar('.'));
+    for (int i = 0; i < FLASH_ROW_WORDS; i++)
+    {
+        char symbol = data[i * 2];
+        if ((symbol >= 0x20) && (symbol < 0x7F))
+            text[i] = QLatin1Char(symbol);
+    }
+    return text;
+}
+
+QString FlashDataModel::configText(int32_t rowAddress) const
+{
+    if (rowAddress < FLASH_CONFIG_ADDRESS)
+        return QString();
+    QStringList words;
+    for (int i = 0; i < FLASH_ROW_WORDS; i++)
+    {
+        const char *name = configWordName(rowAddress + i);
+        if (name != 0)
+            words.append(QString("%1: %2").arg(QString(name)).arg(m_image->word(rowAddress + i), 0, 16));
+    }
+    return words.join(", ");
+}
@@ -0,0 +1,51 @@
+#ifndef FLASH_DATA_MODEL_H
+#define FLASH_DATA_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+#include "flash_image.h"
+
+// Table view over present rows of FlashImage. Text is formatted only for requested cells,
+// so dump of full flash costs nothing until rows are scrolled into view.
+class FlashDataModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        AddressColumn = 0,
+        FirstWordColumn = 1,
+        AsciiColumn = FirstWordColumn + FLASH_ROW_WORDS,
+        DecodeColumn,
+        ColumnsNum
+    };
+
+    explicit FlashDataModel(const FlashImage *image, QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    // IMAGE WAS CLEARED OR REPLACED
+    void reload();
+
+    // ROW WITH WORD address WAS CHANGED OR ADDED TO IMAGE
+    void updateRow(int32_t address);
+
+private:
+    const FlashImage *m_image;
+
+    QVector<int32_t> m_rows;
+
+    QString asciiText(int32_t rowAddress) const;
+
+    QString configText(int32_t rowAddress) const;
+};
+
+#endif // FLASH_DATA_MODEL_H
@@ -0,0 +1,51 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2020-08-30T00:06:16
+#
+#-------------------------------------------------
+
+QT       += core gui
+QT       += serialport
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = lin_corrector_control
+TEMPLATE = app
+
+CONFIG += c++11
+
+# The following define makes your compiler emit warnings if you use
+# any feature of Qt which has been marked as deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# You can also make your code fail to compile if you use deprecated APIs.
+# In order to do so, uncomment the following line.
+# You can also select to disable deprecated APIs only up to a certain version of Qt.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+
+include(../core/core.pri)
+
+SOURCES += \
+        main.cpp \
+        corrector_control.cpp \
+    flash_data_model.cpp \
+    serial_log.cpp \
+    multi_flash_dialog.cpp \
+    values_plot.cpp \
+    current_values_model.cpp \
+    settings_table_model.cpp
+
+HEADERS += \
+        corrector_control.h \
+    flash_data_model.h \
+    serial_log.h \
+    multi_flash_dialog.h \
+    values_plot.h \
+    current_values_model.h \
+    settings_table_model.h
+
+FORMS += \
+        corrector_control.ui
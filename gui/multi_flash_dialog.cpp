@@ -0,0 +1,203 @@
+#include "multi_flash_dialog.h"
+#include "flash_job.h"
+#include "flash_write_plan.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QListWidget>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QProgressBar>
+#include <QLabel>
+#include <QtSerialPort/qserialportinfo.h>
+
+MultiFlashDialog::MultiFlashDialog(const FlashImage &image, int baudRate, const QString &snapshotDirectory, QWidget *parent) :
+    QDialog(parent),
+    m_image(image),
+    m_baudRate(baudRate),
+    m_snapshotDirectory(snapshotDirectory),
+    m_finished(0),
+    m_succeeded(0),
+    m_bytes(0)
+{
+    setWindowTitle("Multi-port flash");
+
+    m_ports = new QListWidget(this);
+    m_portPath = new QLineEdit(this);
+    m_portPath->setPlaceholderText("Other port name or path");
+    QPushButton *add = new QPushButton("Add", this);
+    QPushButton *reflesh = new QPushButton("Reflesh", this);
+    m_verify = new QCheckBox("Verify after write", this);
+    m_verify->setChecked(true);
+    m_differential = new QCheckBox("Only changed rows", this);
+    m_differential->setToolTip("Skip rows equal to snapshot of device in " + m_snapshotDirectory);
+    m_resume = new QCheckBox("Resume", this);
+    m_resume->setToolTip("Continue interrupted write from first row not confirmed on same port, image and device");
+    m_start = new QPushButton("Start", this);
+    m_stop = new QPushButton("Stop", this);
+    m_stop->setEnabled(false);
+
+    m_results = new QTableWidget(0, ColumnsNum, this);
+    m_results->setHorizontalHeaderLabels(QStringList() << "Port" << "Progress" << "Throughput" << "Result");
+    m_results->verticalHeader()->setVisible(false);
+    m_results->horizontalHeader()->setStretchLastSection(true);
+    m_results->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_summary = new QLabel(FlashWritePlan(m_image).summary(m_baudRate), this);
+
+    QHBoxLayout *pathLayout = new QHBoxLayout;
+    pathLayout->addWidget(m_portPath);
+    pathLayout->addWidget(add);
+    pathLayout->addWidget(reflesh);
+    QHBoxLayout *buttonsLayout = new QHBoxLayout;
+    buttonsLayout->addWidget(m_verify);
+    buttonsLayout->addWidget(m_differential);
+    buttonsLayout->addWidget(m_resume);
+    buttonsLayout->addStretch();
+    buttonsLayout->addWidget(m_start);
+    buttonsLayout->addWidget(m_stop);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_ports);
+    layout->addLayout(pathLayout);
+    layout->addLayout(buttonsLayout);
+    layout->addWidget(m_results, 1);
+    layout->addWidget(m_summary);
+    resize(560, 480);
+
+    connect(add, &QPushButton::clicked, this, &MultiFlashDialog::addPort);
+    connect(reflesh, &QPushButton::clicked, this, &MultiFlashDialog::refleshPorts);
+    connect(m_start, &QPushButton::clicked, this, &MultiFlashDialog::start);
+    connect(m_stop, &QPushButton::clicked, this, &MultiFlashDialog::stop);
+
+    refleshPorts();
+}
+
+MultiFlashDialog::~MultiFlashDialog()
+{
+    stop();
+    m_pool.waitForDone();
+    qDeleteAll(m_jobs);
+}
+
+void MultiFlashDialog::reject()
+{
+    // JOBS MUST FINISH BEFORE DIALOG IS CLOSED
+    if (!m_stop->isEnabled())
+        QDialog::reject();
+}
+
+void MultiFlashDialog::refleshPorts()
+{
+    m_ports->clear();
+    foreach (const QSerialPortInfo &info, QSerialPortInfo::availablePorts())
+    {
+        QListWidgetItem *item = new QListWidgetItem(info.portName(), m_ports);
+        item->setToolTip(info.description());
+        item->setCheckState(Qt::Unchecked);
+    }
+}
+
+void MultiFlashDialog::addPort()
+{
+    if (m_portPath->text().isEmpty())
+        return;
+    QListWidgetItem *item = new QListWidgetItem(m_portPath->text(), m_ports);
+    item->setCheckState(Qt::Checked);
+    m_portPath->clear();
+}
+
+void MultiFlashDialog::start()
+{
+    QStringList portNames;
+    for (int i = 0; i < m_ports->count(); i++)
+        if (m_ports->item(i)->checkState() == Qt::Checked)
+            portNames.append(m_ports->item(i)->text());
+    if (portNames.isEmpty() || m_image.isEmpty())
+        return;
+
+    qDeleteAll(m_jobs);
+    m_jobs.clear();
+    m_results->setRowCount(portNames.size());
+    m_finished = 0;
+    m_succeeded = 0;
+    m_bytes = 0;
+    for (int i = 0; i < portNames.size(); i++)
+    {
+        m_results->setItem(i, PortColumn, new QTableWidgetItem(portNames.at(i)));
+        QProgressBar *bar = new QProgressBar(m_results);
+        bar->setValue(0);
+        m_results->setCellWidget(i, ProgressColumn, bar);
+        m_results->setItem(i, ThroughputColumn, new QTableWidgetItem());
+        m_results->setItem(i, ResultColumn, new QTableWidgetItem("Waiting"));
+
+        FlashJob *job = new FlashJob(i, portNames.at(i), m_baudRate, m_image, m_verify->isChecked());
+        if (m_differential->isChecked())
+            job->setSnapshotDirectory(m_snapshotDirectory);
+        job->setResume(m_resume->isChecked());
+        connect(job, &FlashJob::progress, this, &MultiFlashDialog::jobProgress);
+        connect(job, &FlashJob::finished, this, &MultiFlashDialog::jobFinished);
+        m_jobs.append(job);
+    }
+
+    // EVERY PORT GETS OWN THREAD, WAITING FOR BUS DOES NOT LOAD CPU
+    m_pool.setMaxThreadCount(qMax(portNames.size(), QThread::idealThreadCount()));
+    m_time.start();
+    foreach (FlashJob *job, m_jobs)
+        m_pool.start(job);
+
+    m_start->setEnabled(false);
+    m_stop->setEnabled(true);
+    m_ports->setEnabled(false);
+    updateSummary();
+}
+
+void MultiFlashDialog::stop()
+{
+    foreach (FlashJob *job, m_jobs)
+        job->abort();
+}
+
+void MultiFlashDialog::jobProgress(int index, int done, int total)
+{
+    QProgressBar *bar = qobject_cast<QProgressBar*>(m_results->cellWidget(index, ProgressColumn));
+    if (bar == 0)
+        return;
+    bar->setMaximum(total);
+    bar->setValue(done);
+    m_results->item(index, ResultColumn)->setText(m_verify->isChecked() ? "Writing and verifying" : "Writing");
+}
+
+void MultiFlashDialog::jobFinished(int index, bool ok, const QString &result, qint64 elapsed, int bytes)
+{
+    m_finished++;
+    if (ok)
+    {
+        m_succeeded++;
+        m_bytes += bytes;
+        QProgressBar *bar = qobject_cast<QProgressBar*>(m_results->cellWidget(index, ProgressColumn));
+        if (bar != 0)
+            bar->setValue(bar->maximum());
+    }
+    if (elapsed > 0)
+        m_results->item(index, ThroughputColumn)->setText(QString("%1 B/s").arg(bytes * 1000 / elapsed));
+    m_results->item(index, ResultColumn)->setText(result);
+    m_results->item(index, ResultColumn)->setForeground(ok ? Qt::darkGreen : Qt::red);
+
+    if (m_finished == m_jobs.size())
+    {
+        m_start->setEnabled(true);
+        m_stop->setEnabled(false);
+        m_ports->setEnabled(true);
+    }
+    updateSummary();
+}
+
+void MultiFlashDialog::updateSummary()
+{
+    qint64 elapsed = m_time.isValid() ? m_time.elapsed() : 0;
+    m_summary->setText(QString("%1 rows, %2/%3 ports done, %4 OK, %5 ms, total %6 B/s")
+                       .arg(FlashWritePlan(m_image).frames()).arg(m_finished).arg(m_jobs.size()).arg(m_succeeded)
+                       .arg(elapsed).arg(elapsed > 0 ? m_bytes * 1000 / elapsed : 0));
+}
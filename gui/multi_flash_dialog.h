@@ -0,0 +1,96 @@
+#ifndef MULTI_FLASH_DIALOG_H
+#define MULTI_FLASH_DIALOG_H
+
+#include <QDialog>
+#include <QThreadPool>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QList>
+
+#include "flash_image.h"
+
+class QListWidget;
+class QLineEdit;
+class QCheckBox;
+class QPushButton;
+class QTableWidget;
+class QLabel;
+class FlashJob;
+
+// Flashes one image through several adapters at once and shows per-port and total result.
+class MultiFlashDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    MultiFlashDialog(const FlashImage &image, int baudRate, const QString &snapshotDirectory, QWidget *parent = 0);
+    ~MultiFlashDialog();
+
+protected:
+
+    virtual void reject();
+
+private slots:
+
+    void refleshPorts();
+
+    void addPort();
+
+    void start();
+
+    void stop();
+
+    void jobProgress(int index, int done, int total);
+
+    void jobFinished(int index, bool ok, const QString &result, qint64 elapsed, int bytes);
+
+private:
+    enum Columns
+    {
+        PortColumn,
+        ProgressColumn,
+        ThroughputColumn,
+        ResultColumn,
+        ColumnsNum
+    };
+
+    FlashImage m_image;
+
+    int m_baudRate;
+
+    QString m_snapshotDirectory;
+
+    QListWidget *m_ports;
+
+    QLineEdit *m_portPath;
+
+    QCheckBox *m_verify;
+
+    QCheckBox *m_differential;
+
+    QCheckBox *m_resume;
+
+    QPushButton *m_start;
+
+    QPushButton *m_stop;
+
+    QTableWidget *m_results;
+
+    QLabel *m_summary;
+
+    QThreadPool m_pool;
+
+    QList<FlashJob*> m_jobs;
+
+    QElapsedTimer m_time;
+
+    int m_finished;
+
+    int m_succeeded;
+
+    qint64 m_bytes;
+
+    void updateSummary();
+};
+
+#endif // MULTI_FLASH_DIALOG_H
@@ -0,0 +1,220 @@
+#include "serial_log.h"
+
+#include <QPlainTextEdit>
+#include <QDateTime>
+#include <QtEndian>
+
+#include <string.h>
+
+SerialLogQueue::SerialLogQueue() :
+    m_head(0),
+    m_tail(0),
+    m_dropped(0)
+{
+}
+
+void SerialLogQueue::push(qint64 time, const char *data, int size)
+{
+    while (size > 0)
+    {
+        int tail = m_tail.loadAcquire();
+        int nextTail = (tail + 1) % SERIAL_LOG_QUEUE_SIZE;
+        if (nextTail == m_head.loadAcquire())
+        {
+            m_dropped.fetchAndAddRelaxed(1);
+            return;
+        }
+        SerialLogChunk &chunk = m_chunks[tail];
+        chunk.time = time;
+        chunk.size = qMin(size, SERIAL_LOG_CHUNK_SIZE);
+        memcpy(chunk.data, data, chunk.size);
+        data += chunk.size;
+        size -= chunk.size;
+        m_tail.storeRelease(nextTail);
+    }
+}
+
+bool SerialLogQueue::pop(SerialLogChunk *chunk)
+{
+    int head = m_head.loadAcquire();
+    if (head == m_tail.loadAcquire())
+        return false;
+    const SerialLogChunk &queuedChunk = m_chunks[head];
+    chunk->time = queuedChunk.time;
+    chunk->size = queuedChunk.size;
+    memcpy(chunk->data, queuedChunk.data, queuedChunk.size);
+    m_head.storeRelease((head + 1) % SERIAL_LOG_QUEUE_SIZE);
+    return true;
+}
+
+SerialLogFormatter::SerialLogFormatter(SerialLogQueue *queue) :
+    QObject(0),
+    m_queue(queue),
+    m_timer(0),
+    m_spillMode(SerialLog::NoSpill),
+    m_dropped(0)
+{
+}
+
+void SerialLogFormatter::start()
+{
+    m_timer = new QTimer(this);
+    m_timer->setInterval(SERIAL_LOG_FLUSH_INTERVAL);
+    connect(m_timer, &QTimer::timeout, this, &SerialLogFormatter::drain);
+    m_timer->start();
+}
+
+void SerialLogFormatter::setSpillFile(int mode, const QString &fileName)
+{
+    if (m_spillFile.isOpen())
+        m_spillFile.close();
+    m_spillMode = mode;
+    if (mode == SerialLog::NoSpill)
+        return;
+    m_spillFile.setFileName(fileName);
+    if (!m_spillFile.open(QFile::WriteOnly | QFile::Append))
+        emit formatted(QTime::currentTime().toString("HH:mm:ss") + "\t" + QString("Dump file %1 cant open").arg(fileName));
+}
+
+void SerialLogFormatter::drain()
+{
+    QString text;
+    SerialLogChunk chunk;
+    static const char hexDigits[] = "0123456789abcdef";
+    while (m_queue->pop(&chunk))
+    {
+        QString line = QDateTime::fromMSecsSinceEpoch(chunk.time).toString("HH:mm:ss") + "\t";
+        // " B " OR " BB " PER BYTE, NO LEADING ZERO
+        line.reserve(line.size() + chunk.size * 4);
+        for (int i = 0; i < chunk.size; i++)
+        {
+            uint8_t byte = static_cast<uint8_t>(chunk.data[i]);
+            line += QLatin1Char(' ');
+            if (byte >= 0x10)
+                line += QLatin1Char(hexDigits[byte >> 4]);
+            line += QLatin1Char(hexDigits[byte & 0x0F]);
+            line += QLatin1Char(' ');
+        }
+        spill(chunk, line);
+        text += line;
+        text += '\n';
+    }
+
+    int dropped = m_queue->dropped();
+    if (dropped != m_dropped)
+    {
+        text += QTime::currentTime().toString("HH:mm:ss") + "\t" + QString("%1 received blocks not logged (log queue full)\n").arg(dropped - m_dropped);
+        m_dropped = dropped;
+    }
+
+    if (text.isEmpty())
+        return;
+    text.chop(1);
+    emit formatted(text);
+}
+
+void SerialLogFormatter::spill(const SerialLogChunk &chunk, const QString &line)
+{
+    if (!m_spillFile.isOpen())
+        return;
+    if (m_spillMode == SerialLog::TextSpill)
+    {
+        m_spillFile.write(QDateTime::fromMSecsSinceEpoch(chunk.time).toString("yyyy-MM-dd ").toLatin1());
+        m_spillFile.write(line.toLatin1());
+        m_spillFile.write("\n");
+    }
+    else
+    {
+        // RECORD: TIME (MS SINCE EPOCH, 8 BYTES), SIZE (2 BYTES), DATA - LITTLE ENDIAN
+        qint64 time = qToLittleEndian<qint64>(chunk.time);
+        quint16 size = qToLittleEndian<quint16>(chunk.size);
+        m_spillFile.write(reinterpret_cast<const char*>(&time), sizeof(time));
+        m_spillFile.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        m_spillFile.write(chunk.data, chunk.size);
+    }
+    if (m_spillFile.size() >= SERIAL_LOG_SPILL_FILE_SIZE)
+        rotateSpillFile();
+}
+
+void SerialLogFormatter::rotateSpillFile()
+{
+    QString fileName = m_spillFile.fileName();
+    m_spillFile.close();
+    QFile::remove(QString("%1.%2").arg(fileName).arg(SERIAL_LOG_SPILL_FILES_NUM - 1));
+    for (int i = SERIAL_LOG_SPILL_FILES_NUM - 2; i > 0; i--)
+        QFile::rename(QString("%1.%2").arg(fileName).arg(i), QString("%1.%2").arg(fileName).arg(i + 1));
+    QFile::rename(fileName, fileName + ".1");
+    m_spillFile.open(QFile::WriteOnly | QFile::Truncate);
+}
+
+SerialLog::SerialLog(QPlainTextEdit *view, QObject *parent) :
+    QObject(parent),
+    m_view(view),
+    m_verbosity(RawHexDump),
+    m_queue(new SerialLogQueue)
+{
+    m_view->setMaximumBlockCount(SERIAL_LOG_MAX_LINES);
+
+    m_flushTimer.setInterval(SERIAL_LOG_FLUSH_INTERVAL);
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &SerialLog::flush);
+
+    m_formatter = new SerialLogFormatter(m_queue);
+    m_formatter->moveToThread(&m_formatterThread);
+    connect(&m_formatterThread, &QThread::started, m_formatter, &SerialLogFormatter::start);
+    connect(&m_formatterThread, &QThread::finished, m_formatter, &QObject::deleteLater);
+    connect(m_formatter, &SerialLogFormatter::formatted, this, &SerialLog::appendFormatted);
+    m_formatterThread.start(QThread::LowPriority);
+}
+
+SerialLog::~SerialLog()
+{
+    m_formatterThread.quit();
+    m_formatterThread.wait();
+    delete m_queue;
+}
+
+void SerialLog::rawData(const char *data, int size)
+{
+    if (m_verbosity.loadAcquire() == MessagesOnly)
+        return;
+    m_queue->push(QDateTime::currentMSecsSinceEpoch(), data, size);
+}
+
+void SerialLog::setVerbosity(int verbosity)
+{
+    m_verbosity.storeRelease(verbosity);
+}
+
+void SerialLog::setSpillFile(int mode, const QString &fileName)
+{
+    QMetaObject::invokeMethod(m_formatter, "setSpillFile", Qt::QueuedConnection, Q_ARG(int, mode), Q_ARG(QString, fileName));
+}
+
+void SerialLog::message(const QString &text)
+{
+    m_pending.append(QTime::currentTime().toString("HH:mm:ss") + "\t" + text);
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void SerialLog::clear()
+{
+    m_pending.clear();
+    m_view->clear();
+}
+
+void SerialLog::appendFormatted(const QString &text)
+{
+    m_pending.append(text);
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void SerialLog::flush()
+{
+    if (m_pending.isEmpty())
+        return;
+    m_view->appendPlainText(m_pending.join("\n"));
+    m_pending.clear();
+}
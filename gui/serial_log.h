@@ -0,0 +1,147 @@
+#ifndef SERIAL_LOG_H
+#define SERIAL_LOG_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QFile>
+
+class QPlainTextEdit;
+
+#define SERIAL_LOG_CHUNK_SIZE       256
+#define SERIAL_LOG_QUEUE_SIZE       256
+#define SERIAL_LOG_FLUSH_INTERVAL   100
+#define SERIAL_LOG_MAX_LINES        5000
+#define SERIAL_LOG_SPILL_FILE_SIZE  (8 * 1024 * 1024)
+#define SERIAL_LOG_SPILL_FILES_NUM  4
+
+struct SerialLogChunk
+{
+    qint64 time;
+    int size;
+    char data[SERIAL_LOG_CHUNK_SIZE];
+};
+
+// Lock-free queue for one producer thread (port reader) and one consumer thread (formatter).
+// Chunks not fitting to queue are dropped and counted.
+class SerialLogQueue
+{
+public:
+    SerialLogQueue();
+
+    void push(qint64 time, const char *data, int size);
+
+    bool pop(SerialLogChunk *chunk);
+
+    int dropped() const { return m_dropped.load(); }
+
+private:
+    SerialLogChunk m_chunks[SERIAL_LOG_QUEUE_SIZE];
+
+    QAtomicInt m_head;
+
+    QAtomicInt m_tail;
+
+    QAtomicInt m_dropped;
+};
+
+// Lives in own thread: takes raw chunks from queue, formats them to text lines and
+// writes them to spill file.
+class SerialLogFormatter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SerialLogFormatter(SerialLogQueue *queue);
+
+public slots:
+
+    void start();
+
+    void setSpillFile(int mode, const QString &fileName);
+
+    void drain();
+
+signals:
+
+    void formatted(const QString &text);
+
+private:
+    SerialLogQueue *m_queue;
+
+    QTimer *m_timer;
+
+    int m_spillMode;
+
+    QFile m_spillFile;
+
+    int m_dropped;
+
+    void spill(const SerialLogChunk &chunk, const QString &line);
+
+    void rotateSpillFile();
+};
+
+// Log of program messages and raw received bytes. Text is appended to widget by batches,
+// not more often than SERIAL_LOG_FLUSH_INTERVAL ms, widget keeps last SERIAL_LOG_MAX_LINES lines.
+class SerialLog : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Verbosity
+    {
+        MessagesOnly,
+        RawHexDump
+    };
+
+    enum SpillMode
+    {
+        NoSpill,
+        TextSpill,
+        BinarySpill
+    };
+
+    explicit SerialLog(QPlainTextEdit *view, QObject *parent = 0);
+    ~SerialLog();
+
+    Verbosity verbosity() const { return static_cast<Verbosity>(m_verbosity.load()); }
+
+    // RAW BYTES FROM ONE THREAD ONLY
+    void rawData(const char *data, int size);
+
+public slots:
+
+    void setVerbosity(int verbosity);
+
+    void setSpillFile(int mode, const QString &fileName);
+
+    void message(const QString &text);
+
+    void clear();
+
+private slots:
+
+    void appendFormatted(const QString &text);
+
+    void flush();
+
+private:
+    QPlainTextEdit *m_view;
+
+    QStringList m_pending;
+
+    QTimer m_flushTimer;
+
+    QAtomicInt m_verbosity;
+
+    SerialLogQueue *m_queue;
+
+    QThread m_formatterThread;
+
+    SerialLogFormatter *m_formatter;
+};
+
+#endif // SERIAL_LOG_H
@@ -0,0 +1,143 @@
+#include "settings_table_model.h"
+
+#include <QtMath>
+
+namespace {
+
+int8_t toPosition(qreal value)
+{
+    return static_cast<int8_t>(qBound(-128, qRound(value), 127));
+}
+
+}
+
+SettingsTableModel::SettingsTableModel(ControllerSettings *settings, QObject *parent) :
+    QAbstractTableModel(parent),
+    m_settings(settings)
+{
+}
+
+int SettingsTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : qMin<int>(m_settings->positionsNum, SETTINGS_POSITIONS_MAX);
+}
+
+int SettingsTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : (FirstCorrectorColumn + qMin<int>(m_settings->correctorsNum, SETTINGS_CORRECTORS_MAX));
+}
+
+QVariant SettingsTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || ((role != Qt::DisplayRole) && (role != Qt::EditRole)))
+        return QVariant();
+    if (index.column() == AdcColumn)
+    {
+        if (index.row() == (rowCount() - 1))
+            return QVariant();
+        return m_settings->adcValues[index.row()];
+    }
+    return m_settings->positions[index.column() - FirstCorrectorColumn][index.row()] * m_settings->positionMult;
+}
+
+bool SettingsTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || (role != Qt::EditRole) || !(flags(index) & Qt::ItemIsEditable))
+        return false;
+    bool ok;
+    int number = value.toInt(&ok);
+    if (!ok)
+        return false;
+    if (index.column() == AdcColumn)
+        m_settings->adcValues[index.row()] = static_cast<uint8_t>(qBound(0, number, 255));
+    else
+        m_settings->positions[index.column() - FirstCorrectorColumn][index.row()] = toPosition(qreal(number) / qMax<int>(m_settings->positionMult, 1));
+    emit dataChanged(index, index);
+    return true;
+}
+
+Qt::ItemFlags SettingsTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    // LAST POSITION HAS NO ADC VALUE
+    if ((index.column() == AdcColumn) && (index.row() == (rowCount() - 1)))
+        return Qt::ItemIsEnabled;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+QVariant SettingsTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole))
+        return QAbstractTableModel::headerData(section, orientation, role);
+    if (section == AdcColumn)
+        return QString("Adc value");
+    return QString("Corrector %1").arg(section - FirstCorrectorColumn + 1);
+}
+
+void SettingsTableModel::reload()
+{
+    beginResetModel();
+    endResetModel();
+}
+
+void SettingsTableModel::setPositionsNum(int num)
+{
+    num = qBound(2, num, SETTINGS_POSITIONS_MAX);
+    while (m_settings->positionsNum < num)
+    {
+        int row = m_settings->positionsNum;
+        beginInsertRows(QModelIndex(), row, row);
+        // PREVIOUS LAST ROW GETS ADC VALUE, NEW ROW REPEATS ITS POSITIONS
+        m_settings->adcValues[row - 1] = m_settings->adcValues[row - 2];
+        for (int i = 0; i < SETTINGS_CORRECTORS_MAX; i++)
+            m_settings->positions[i][row] = m_settings->positions[i][row - 1];
+        m_settings->positionsNum++;
+        endInsertRows();
+        emit dataChanged(index(row - 1, AdcColumn), index(row - 1, AdcColumn));
+    }
+    while (m_settings->positionsNum > num)
+    {
+        int row = m_settings->positionsNum - 1;
+        beginRemoveRows(QModelIndex(), row, row);
+        m_settings->positionsNum--;
+        endRemoveRows();
+        emit dataChanged(index(row - 1, AdcColumn), index(row - 1, AdcColumn));
+    }
+}
+
+void SettingsTableModel::setCorrectorsNum(int num)
+{
+    num = qBound(0, num, SETTINGS_CORRECTORS_MAX);
+    while (m_settings->correctorsNum < num)
+    {
+        int corrector = m_settings->correctorsNum;
+        beginInsertColumns(QModelIndex(), FirstCorrectorColumn + corrector, FirstCorrectorColumn + corrector);
+        // NEW CORRECTOR STARTS AS COPY OF FIRST ONE
+        if (corrector > 0)
+            for (int i = 0; i < SETTINGS_POSITIONS_MAX; i++)
+                m_settings->positions[corrector][i] = m_settings->positions[0][i];
+        m_settings->correctorsNum++;
+        endInsertColumns();
+    }
+    while (m_settings->correctorsNum > num)
+    {
+        int column = FirstCorrectorColumn + m_settings->correctorsNum - 1;
+        beginRemoveColumns(QModelIndex(), column, column);
+        m_settings->correctorsNum--;
+        endRemoveColumns();
+    }
+}
+
+void SettingsTableModel::setPositionMult(int mult)
+{
+    if ((mult <= 0) || (mult == m_settings->positionMult))
+        return;
+    int oldMult = qMax<int>(m_settings->positionMult, 1);
+    for (int i = 0; i < qMin<int>(m_settings->correctorsNum, SETTINGS_CORRECTORS_MAX); i++)
+        for (int j = 0; j < rowCount(); j++)
+            m_settings->positions[i][j] = toPosition(qreal(m_settings->positions[i][j]) * oldMult / mult);
+    m_settings->positionMult = static_cast<uint8_t>(mult);
+    if (columnCount() > FirstCorrectorColumn)
+        emit dataChanged(index(0, FirstCorrectorColumn), index(rowCount() - 1, columnCount() - 1));
+}
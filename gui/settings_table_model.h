@@ -0,0 +1,51 @@
+#ifndef SETTINGS_TABLE_MODEL_H
+#define SETTINGS_TABLE_MODEL_H
+
+#include <QAbstractTableModel>
+
+#include "controller_settings.h"
+
+// Table of ADC values and corrector positions of ControllerSettings: one row per position,
+// ADC column and one column per corrector. Edit of cell changes one field and reports
+// one dataChanged; change of positions or correctors number inserts or removes rows or
+// columns, new ones start as copy of neighbours, as table worked before.
+class SettingsTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        AdcColumn = 0,
+        FirstCorrectorColumn = 1
+    };
+
+    explicit SettingsTableModel(ControllerSettings *settings, QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole);
+
+    Qt::ItemFlags flags(const QModelIndex &index) const;
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    // SETTINGS WERE REPLACED
+    void reload();
+
+    void setPositionsNum(int num);
+
+    void setCorrectorsNum(int num);
+
+    // POSITIONS KEEP DISPLAYED VALUES, STORED ONES ARE ROUNDED TO NEW MULT
+    void setPositionMult(int mult);
+
+private:
+    ControllerSettings *m_settings;
+};
+
+#endif // SETTINGS_TABLE_MODEL_H
@@ -0,0 +1,261 @@
+#include "values_plot.h"
+
+#include <QPainter>
+
+PlotHistory::PlotHistory()
+{
+    for (int i = 0; i < PLOT_LEVELS; i++)
+        m_levels[i].ring.resize(PLOT_LEVEL_CAPACITY);
+    clear();
+}
+
+void PlotHistory::append(float value)
+{
+    PlotBucket bucket = {value, value};
+    push(0, bucket);
+}
+
+void PlotHistory::clear()
+{
+    for (int i = 0; i < PLOT_LEVELS; i++)
+    {
+        m_levels[i].count = 0;
+        m_levels[i].pendingCount = 0;
+    }
+}
+
+void PlotHistory::push(int level, const PlotBucket &bucket)
+{
+    Level &current = m_levels[level];
+    current.ring[current.count % PLOT_LEVEL_CAPACITY] = bucket;
+    current.count++;
+    if (level + 1 >= PLOT_LEVELS)
+        return;
+
+    Level &upper = m_levels[level + 1];
+    if (upper.pendingCount == 0)
+        upper.pending = bucket;
+    else
+    {
+        upper.pending.min = qMin(upper.pending.min, bucket.min);
+        upper.pending.max = qMax(upper.pending.max, bucket.max);
+    }
+    if (++upper.pendingCount == PLOT_LEVEL_FACTOR)
+    {
+        upper.pendingCount = 0;
+        push(level + 1, upper.pending);
+    }
+}
+
+quint64 PlotHistory::items(int level) const
+{
+    const Level &current = m_levels[level];
+    return qMin<quint64>(current.count, PLOT_LEVEL_CAPACITY) + ((current.pendingCount > 0) ? 1 : 0);
+}
+
+const PlotBucket &PlotHistory::item(int level, quint64 age) const
+{
+    const Level &current = m_levels[level];
+    if (current.pendingCount > 0)
+    {
+        if (age == 0)
+            return current.pending;
+        age--;
+    }
+    return current.ring.at((current.count - 1 - age) % PLOT_LEVEL_CAPACITY);
+}
+
+int PlotHistory::downsample(quint64 samples, int columns, PlotBucket *result) const
+{
+    samples = qMin(samples, count());
+    if ((samples == 0) || (columns <= 0))
+        return 0;
+
+    // COARSEST NEEDED LEVEL: NOT MORE THAN PLOT_LEVEL_FACTOR ITEMS PER COLUMN
+    int level = 0;
+    quint64 unit = 1;
+    quint64 needed = samples;
+    while ((level + 1 < PLOT_LEVELS) && ((needed > quint64(columns) * PLOT_LEVEL_FACTOR) || (needed > items(level))))
+    {
+        level++;
+        unit *= PLOT_LEVEL_FACTOR;
+        needed = (samples + unit - 1) / unit;
+    }
+    quint64 available = qMin(needed, items(level));
+    int filled = static_cast<int>(qMin<quint64>(available, columns));
+
+    for (int column = 0; column < filled; column++)
+    {
+        quint64 from = available * column / filled;
+        quint64 to = available * (column + 1) / filled;
+        PlotBucket bucket = item(level, available - 1 - from);
+        for (quint64 i = from + 1; i < to; i++)
+        {
+            const PlotBucket &next = item(level, available - 1 - i);
+            bucket.min = qMin(bucket.min, next.min);
+            bucket.max = qMax(bucket.max, next.max);
+        }
+        result[column] = bucket;
+    }
+    return filled;
+}
+
+ValuesPlot::ValuesPlot(QWidget *parent) :
+    QWidget(parent),
+    m_window(1000),
+    m_dirty(false)
+{
+    m_names[Temperature] = "Temperature";
+    m_names[AdcValue] = "Adc value";
+    m_names[PositionIndex] = "Position index";
+    m_names[ReadCorrector1] = "Real 1";
+    m_names[WrittenCorrector1] = "Written 1";
+    m_names[ReadCorrector2] = "Real 2";
+    m_names[WrittenCorrector2] = "Written 2";
+    m_colors[Temperature] = Qt::darkRed;
+    m_colors[AdcValue] = Qt::darkBlue;
+    m_colors[PositionIndex] = Qt::darkGreen;
+    m_colors[ReadCorrector1] = Qt::blue;
+    m_colors[WrittenCorrector1] = Qt::cyan;
+    m_colors[ReadCorrector2] = Qt::red;
+    m_colors[WrittenCorrector2] = Qt::magenta;
+
+    Pane pane;
+    pane.title = "Temperature";
+    pane.series = QVector<int>() << Temperature;
+    m_panes.append(pane);
+    pane.title = "Adc value";
+    pane.series = QVector<int>() << AdcValue;
+    m_panes.append(pane);
+    pane.title = "Position index";
+    pane.series = QVector<int>() << PositionIndex;
+    m_panes.append(pane);
+    pane.title = "Corrector values";
+    pane.series = QVector<int>() << ReadCorrector1 << WrittenCorrector1 << ReadCorrector2 << WrittenCorrector2;
+    m_panes.append(pane);
+
+    setMinimumSize(400, 400);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    m_repaintTimer.setSingleShot(true);
+    m_repaintTimer.setInterval(PLOT_FRAME_INTERVAL);
+    connect(&m_repaintTimer, &QTimer::timeout, this, &ValuesPlot::repaintIfDirty);
+}
+
+void ValuesPlot::appendValues(const char *data)
+{
+    m_history[Temperature].append(static_cast<uint8_t>(data[0]));
+    m_history[AdcValue].append(static_cast<uint8_t>(data[1]));
+    m_history[PositionIndex].append(static_cast<uint8_t>(data[2]));
+    m_history[ReadCorrector1].append(static_cast<int16_t>((data[4] << 8) | (data[3] & 0xFF)));
+    m_history[ReadCorrector2].append(static_cast<int16_t>((data[6] << 8) | (data[5] & 0xFF)));
+    m_history[WrittenCorrector1].append(static_cast<int16_t>((data[8] << 8) | (data[7] & 0xFF)));
+    m_history[WrittenCorrector2].append(static_cast<int16_t>((data[10] << 8) | (data[9] & 0xFF)));
+    m_dirty = true;
+    if (!m_repaintTimer.isActive() && isVisible())
+        m_repaintTimer.start();
+}
+
+void ValuesPlot::setWindow(int samples)
+{
+    m_window = qMax(samples, 2);
+    update();
+}
+
+void ValuesPlot::clear()
+{
+    for (int i = 0; i < SeriesNum; i++)
+        m_history[i].clear();
+    update();
+}
+
+void ValuesPlot::repaintIfDirty()
+{
+    if (m_dirty)
+        update();
+}
+
+void ValuesPlot::paintEvent(QPaintEvent *)
+{
+    m_dirty = false;
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+    qreal paneHeight = qreal(height()) / m_panes.size();
+    for (int i = 0; i < m_panes.size(); i++)
+        paintPane(&painter, m_panes.at(i), QRectF(0, i * paneHeight, width(), paneHeight));
+}
+
+void ValuesPlot::paintPane(QPainter *painter, const Pane &pane, const QRectF &rect)
+{
+    QRectF area = rect.adjusted(50, 18, -6, -4);
+    int columns = qMax(static_cast<int>(area.width()), 2);
+    m_buckets.resize(columns * pane.series.size());
+
+    // COMMON SCALE FOR ALL SERIES OF PANE
+    float low = 0;
+    float high = 0;
+    bool empty = true;
+    int filled[SeriesNum];
+    for (int i = 0; i < pane.series.size(); i++)
+    {
+        PlotBucket *buckets = m_buckets.data() + i * columns;
+        filled[i] = m_history[pane.series.at(i)].downsample(m_window, columns, buckets);
+        for (int j = 0; j < filled[i]; j++)
+        {
+            low = empty ? buckets[j].min : qMin(low, buckets[j].min);
+            high = empty ? buckets[j].max : qMax(high, buckets[j].max);
+            empty = false;
+        }
+    }
+    if (high - low < 1)
+    {
+        low -= 1;
+        high += 1;
+    }
+
+    painter->setPen(Qt::lightGray);
+    painter->drawRect(area);
+    painter->setPen(Qt::black);
+    painter->drawText(QPointF(rect.left() + 4, rect.top() + 14), pane.title);
+    painter->drawText(QRectF(rect.left(), area.top(), 46, 14), Qt::AlignRight, QString::number(high));
+    painter->drawText(QRectF(rect.left(), area.bottom() - 14, 46, 14), Qt::AlignRight, QString::number(low));
+
+    qreal legend = area.right();
+    for (int i = pane.series.size() - 1; (i >= 0) && (pane.series.size() > 1); i--)
+    {
+        QString name = m_names[pane.series.at(i)];
+        legend -= painter->fontMetrics().horizontalAdvance(name) + 10;
+        painter->setPen(m_colors[pane.series.at(i)]);
+        painter->drawText(QPointF(legend, rect.top() + 14), name);
+    }
+
+    qreal yScale = area.height() / (high - low);
+    for (int i = 0; i < pane.series.size(); i++)
+    {
+        int series = pane.series.at(i);
+        if (filled[i] == 0)
+            continue;
+        const PlotBucket *buckets = m_buckets.constData() + i * columns;
+        // SHORT HISTORY TAKES RIGHT PART OF PLOT ONLY
+        qreal span = area.width() * qMin<quint64>(m_history[series].count(), m_window) / m_window;
+        qreal step = (filled[i] > 1) ? span / (filled[i] - 1) : 0;
+        qreal x = area.right() - span;
+
+        m_lines.clear();
+        QPointF previous;
+        for (int j = 0; j < filled[i]; j++, x += step)
+        {
+            qreal top = area.bottom() - (buckets[j].max - low) * yScale;
+            qreal bottom = area.bottom() - (buckets[j].min - low) * yScale;
+            QPointF middle(x, (top + bottom) / 2);
+            if (top != bottom)
+                m_lines.append(QLineF(x, top, x, bottom));
+            if (j > 0)
+                m_lines.append(QLineF(previous, middle));
+            previous = middle;
+        }
+        painter->setPen(m_colors[series]);
+        painter->drawLines(m_lines);
+        if (m_lines.isEmpty())
+            painter->drawPoint(previous);
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef VALUES_PLOT_H
+#define VALUES_PLOT_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QVector>
+#include <QLineF>
+#include <QColor>
+
+#define PLOT_LEVELS         4
+#define PLOT_LEVEL_FACTOR   16
+#define PLOT_LEVEL_CAPACITY 4096
+#define PLOT_FRAME_INTERVAL 40
+
+struct PlotBucket
+{
+    float min;
+    float max;
+};
+
+// History of one value in preallocated rings of PLOT_LEVELS levels. Level 0 keeps samples,
+// each next level keeps min/max of PLOT_LEVEL_FACTOR buckets of previous one, so last
+// PLOT_LEVEL_CAPACITY * PLOT_LEVEL_FACTOR ^ (PLOT_LEVELS - 1) samples can be drawn at
+// cost bounded by plot width, whatever window is asked.
+class PlotHistory
+{
+public:
+    PlotHistory();
+
+    void append(float value);
+
+    void clear();
+
+    quint64 count() const { return m_levels[0].count; }
+
+    // MIN/MAX OF LAST SAMPLES IN UP TO columns BUCKETS, OLDEST FIRST, RETURNS BUCKETS FILLED
+    int downsample(quint64 samples, int columns, PlotBucket *result) const;
+
+private:
+    struct Level
+    {
+        QVector<PlotBucket> ring;
+        quint64 count;          // COMPLETE BUCKETS
+        PlotBucket pending;     // BUCKET BEING FILLED FROM PREVIOUS LEVEL
+        int pendingCount;
+    };
+
+    Level m_levels[PLOT_LEVELS];
+
+    void push(int level, const PlotBucket &bucket);
+
+    // NEWEST FIRST, PENDING BUCKET COUNTS AS NEWEST
+    const PlotBucket &item(int level, quint64 age) const;
+
+    quint64 items(int level) const;
+};
+
+// Live charts of values frames: temperature, ADC value, position index and read vs written
+// corrector values. Samples only mark plot dirty; repaint is done by timer, not more often
+// than every PLOT_FRAME_INTERVAL ms, whatever rate frames come at.
+class ValuesPlot : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum Series
+    {
+        Temperature,
+        AdcValue,
+        PositionIndex,
+        ReadCorrector1,
+        WrittenCorrector1,
+        ReadCorrector2,
+        WrittenCorrector2,
+        SeriesNum
+    };
+
+    explicit ValuesPlot(QWidget *parent = 0);
+
+    // VALUES FRAME DATA WITHOUT SYNC, CODE AND CHECKSUM
+    void appendValues(const char *data);
+
+    quint64 window() const { return m_window; }
+
+public slots:
+
+    void setWindow(int samples);
+
+    void clear();
+
+protected:
+
+    virtual void paintEvent(QPaintEvent *);
+
+private slots:
+
+    void repaintIfDirty();
+
+private:
+    struct Pane
+    {
+        QString title;
+        QVector<int> series;
+    };
+
+    PlotHistory m_history[SeriesNum];
+
+    QColor m_colors[SeriesNum];
+
+    QString m_names[SeriesNum];
+
+    QVector<Pane> m_panes;
+
+    quint64 m_window;
+
+    bool m_dirty;
+
+    QTimer m_repaintTimer;
+
+    // REUSED BY EVERY PAINT
+    QVector<PlotBucket> m_buckets;
+
+    QVector<QLineF> m_lines;
+
+    void paintPane(QPainter *painter, const Pane &pane, const QRectF &rect);
+};
+
+#endif // VALUES_PLOT_H
@@ -4,34 +4,18 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
-QT       += serialport
+TEMPLATE = subdirs
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+SUBDIRS += \
+    core \
+    gui \
+    cli
 
-TARGET = lin_corrector_control
-TEMPLATE = app
+gui.depends = core
+cli.depends = core
 
-# The following define makes your compiler emit warnings if you use
-# any feature of Qt which has been marked as deprecated (the exact warnings
-# depend on your compiler). Please consult the documentation of the
-# deprecated API in order to know how to port your code away from it.
-DEFINES += QT_DEPRECATED_WARNINGS
-
-# You can also make your code fail to compile if you use deprecated APIs.
-# In order to do so, uncomment the following line.
-# You can also select to disable deprecated APIs only up to a certain version of Qt.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-
-SOURCES += \
-        main.cpp \
-        corrector_control.cpp \
-    hex_converter.cpp
-
-HEADERS += \
-        corrector_control.h \
-    hex_converter.h
-
-FORMS += \
-        corrector_control.ui
+# PSEUDO-TERMINAL EMULATOR NEEDS POSIX PTY
+unix {
+    SUBDIRS += emulator
+    emulator.depends = core
+}